@@ -0,0 +1,139 @@
+// Compare the previous unordered_map based ComponentArray with the sparse-set one.
+// Build the `component_array_bench` target and run it, no window or device needed.
+
+#include "../src/ECS/Base/component_array.hpp"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct Body {
+  float position[3];
+  float velocity[3];
+  float acceleration[3];
+  float mass;
+};
+
+// Storage as it was before the sparse set, sized at runtime to go past MAX_ENTITIES
+template <typename T> class LegacyComponentArray {
+public:
+  explicit LegacyComponentArray(size_t capacity) : mComponentArray(capacity) {}
+
+  // no change ticks
+  void insertData(ecs::Entity entity, T component, ecs::Tick) {
+    mEntityToIndex[entity] = currentSize;
+    mIndexToEntity[currentSize] = entity;
+    mComponentArray[currentSize] = component;
+    ++currentSize;
+  }
+
+  void removeData(ecs::Entity entity) {
+    size_t removedEntityIndex = mEntityToIndex[entity];
+    size_t lastEntityIndex = currentSize - 1;
+    mComponentArray[removedEntityIndex] = mComponentArray[lastEntityIndex];
+
+    ecs::Entity lastElement = mIndexToEntity[lastEntityIndex];
+    mEntityToIndex[lastElement] = removedEntityIndex;
+    mIndexToEntity[removedEntityIndex] = lastElement;
+    mEntityToIndex.erase(entity);
+    mIndexToEntity.erase(lastEntityIndex);
+
+    --currentSize;
+  }
+
+  T &getData(ecs::Entity entity) { return mComponentArray[mEntityToIndex[entity]]; }
+
+private:
+  std::vector<T> mComponentArray;
+  std::unordered_map<ecs::Entity, size_t> mEntityToIndex{};
+  std::unordered_map<size_t, ecs::Entity> mIndexToEntity{};
+  size_t currentSize{0};
+};
+
+struct Timings {
+  double insert;
+  double update;
+  double remove;
+};
+
+template <typename F> double measureMs(F &&f) {
+  auto start = std::chrono::high_resolution_clock::now();
+  f();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// insert every entity, run a few GravitySystem-like passes, then remove half of them
+template <typename Array>
+Timings run(Array &array, const std::vector<ecs::Entity> &entities,
+            const std::vector<ecs::Entity> &removed, int frames) {
+  Timings t{};
+
+  t.insert = measureMs([&] {
+    for (ecs::Entity e : entities) {
+      array.insertData(e, Body{{0.f, 30.f, 0.f}, {}, {}, 1.f}, ecs::Tick{1});
+    }
+  });
+
+  t.update = measureMs([&] {
+    for (int frame{0}; frame < frames; ++frame) {
+      for (ecs::Entity e : entities) {
+        Body &body = array.getData(e);
+        for (int k{0}; k < 3; ++k) {
+          body.acceleration[k] -= 0.1485f * body.mass;
+          body.velocity[k] += body.acceleration[k] * 0.016f;
+          body.position[k] += body.velocity[k] * 0.016f;
+        }
+      }
+    }
+  });
+
+  t.remove = measureMs([&] {
+    for (ecs::Entity e : removed) {
+      array.removeData(e);
+    }
+  });
+
+  return t;
+}
+
+void bench(size_t count, int frames) {
+  std::vector<ecs::Entity> entities(count);
+  std::iota(entities.begin(), entities.end(), 0);
+
+  std::mt19937 gen(42);
+  std::vector<ecs::Entity> removed = entities;
+  std::shuffle(removed.begin(), removed.end(), gen);
+  removed.resize(count / 2);
+
+  LegacyComponentArray<Body> legacy(count);
+  ecs::ComponentArray<Body> sparse;
+
+  Timings l = run(legacy, entities, removed, frames);
+  Timings s = run(sparse, entities, removed, frames);
+
+  std::printf("%zu entities, %d update passes\n", count, frames);
+  std::printf("  %-10s %12s %12s %9s\n", "", "unordered", "sparse set", "speedup");
+  std::printf("  %-10s %10.3fms %10.3fms %8.1fx\n", "insert", l.insert, s.insert,
+              l.insert / s.insert);
+  std::printf("  %-10s %10.3fms %10.3fms %8.1fx\n", "update", l.update, s.update,
+              l.update / s.update);
+  std::printf("  %-10s %10.3fms %10.3fms %8.1fx\n", "remove", l.remove, s.remove,
+              l.remove / s.remove);
+}
+
+} // namespace
+
+int main() {
+  bench(5000, 100);
+  bench(100000, 10);
+
+  return 0;
+}
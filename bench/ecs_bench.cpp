@@ -0,0 +1,310 @@
+// ECS benchmark suite: create / destroy, add / remove component, single and multi component
+// iteration, signature churn and system dispatch, at 1k, 10k, 100k and 1M entities on both
+// storage backends.
+// Build the `ecs_bench` target, only the machina_ecs library is needed.
+//   ecs_bench [--json <file>] [--max <entities>] [--filter <name>]
+// --json also writes every result to the file, --max skips the bigger worlds and --filter
+// only runs the benchmarks whose name contains the string.
+
+#include "../src/ECS/Base/centralizer.hpp"
+#include "../src/ECS/Base/command_buffer.hpp"
+#include "../src/ECS/Base/scheduler.hpp"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Position {
+  float value[3];
+};
+
+struct Velocity {
+  float value[3];
+};
+
+struct Health {
+  int value;
+};
+
+struct Tag {};
+
+constexpr size_t SIZES[] = {1'000, 10'000, 100'000, 1'000'000};
+// iteration benchmarks repeat until about this many entities were visited
+constexpr size_t VISITS = 20'000'000;
+// share of the entities changing signature per churn frame
+constexpr size_t CHURN_DIVISOR = 10;
+constexpr size_t CHUNK_SIZE = 1024;
+constexpr float DT = 1.f / 60.f;
+
+struct Result {
+  std::string name;
+  const char *backend;
+  size_t entities;
+  // operations measured: entities created, components added, entities visited...
+  size_t operations;
+  double ms;
+};
+
+std::vector<Result> gResults;
+const char *gFilter{nullptr};
+
+template <typename F> double measureMs(F &&f) {
+  auto start = std::chrono::high_resolution_clock::now();
+  f();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+const char *backendName(ecs::StorageBackend backend) {
+  return backend == ecs::StorageBackend::Archetype ? "archetype" : "sparse_set";
+}
+
+bool enabled(const char *name) { return !gFilter || std::strstr(name, gFilter); }
+
+void report(const char *name, ecs::StorageBackend backend, size_t entities, size_t operations,
+            double ms) {
+  gResults.push_back(Result{name, backendName(backend), entities, operations, ms});
+  std::printf("  %-24s %12.3fms %10.2fns/op\n", name, ms, ms * 1e6 / operations);
+}
+
+void registerComponents(ecs::Centralizer &centralizer) {
+  centralizer.registerComponent<Position>();
+  centralizer.registerComponent<Velocity>();
+  centralizer.registerComponent<Health>();
+  centralizer.registerComponent<Tag>();
+}
+
+std::vector<ecs::Entity> spawn(ecs::Centralizer &centralizer, size_t count) {
+  return centralizer.spawnBatch<Position, Velocity>(count, [](size_t i) {
+    return std::tuple{Position{{float(i), 0.f, 0.f}}, Velocity{{0.f, 1.f, 0.f}}};
+  });
+}
+
+size_t frames(size_t count) { return std::max<size_t>(VISITS / count, 1); }
+
+void benchCreateDestroy(ecs::StorageBackend backend, size_t count) {
+  ecs::Centralizer centralizer{backend};
+  registerComponents(centralizer);
+  std::vector<ecs::Entity> entities(count);
+
+  report("create", backend, count, count, measureMs([&] {
+           for (ecs::Entity &e : entities) {
+             e = centralizer.createEntity();
+             centralizer.addComponent(e, Position{{0.f, 0.f, 0.f}});
+           }
+         }));
+  report("destroy", backend, count, count, measureMs([&] {
+           for (ecs::Entity e : entities) {
+             centralizer.destroyEntity(e);
+           }
+         }));
+  report("spawn_batch", backend, count, count, measureMs([&] { spawn(centralizer, count); }));
+}
+
+void benchAddRemove(ecs::StorageBackend backend, size_t count) {
+  ecs::Centralizer centralizer{backend};
+  registerComponents(centralizer);
+  std::vector<ecs::Entity> entities = spawn(centralizer, count);
+
+  report("add_component", backend, count, count, measureMs([&] {
+           for (ecs::Entity e : entities) {
+             centralizer.addComponent(e, Health{100});
+           }
+         }));
+  report("remove_component", backend, count, count, measureMs([&] {
+           for (ecs::Entity e : entities) {
+             centralizer.removeComponent<Health>(e);
+           }
+         }));
+}
+
+void benchIteration(ecs::StorageBackend backend, size_t count) {
+  ecs::Centralizer centralizer{backend};
+  registerComponents(centralizer);
+  std::vector<ecs::Entity> entities = spawn(centralizer, count);
+  // a quarter without Velocity so the join has to skip some
+  for (size_t i{0}; i < count; i += 4) {
+    centralizer.removeComponent<Velocity>(entities[i]);
+  }
+  const size_t n = frames(count);
+
+  report("iterate_single", backend, count, n * count, measureMs([&] {
+           for (size_t frame{0}; frame < n; ++frame) {
+             centralizer.view<Position>().each(
+                 [](ecs::Entity, Position &position) { position.value[1] -= DT; });
+           }
+         }));
+
+  auto integrate = [](ecs::Entity, Position &position, Velocity &velocity) {
+    for (int k{0}; k < 3; ++k) {
+      position.value[k] += velocity.value[k] * DT;
+    }
+  };
+  const size_t moving = centralizer.view<Position, Velocity>().sizeHint();
+  report("iterate_multi", backend, count, n * moving, measureMs([&] {
+           for (size_t frame{0}; frame < n; ++frame) {
+             centralizer.view<Position, Velocity>().each(integrate);
+           }
+         }));
+
+  centralizer.group<Position, Velocity>();
+  report("iterate_group", backend, count, n * moving, measureMs([&] {
+           for (size_t frame{0}; frame < n; ++frame) {
+             centralizer.group<Position, Velocity>().each(integrate);
+           }
+         }));
+}
+
+void benchChurn(ecs::StorageBackend backend, size_t count) {
+  ecs::Centralizer centralizer{backend};
+  registerComponents(centralizer);
+  std::vector<ecs::Entity> entities = spawn(centralizer, count);
+  std::mt19937 rng{42};
+  const size_t perFrame = std::max<size_t>(count / CHURN_DIVISOR, 1);
+  const size_t n = std::max<size_t>(frames(count) / CHURN_DIVISOR, 1);
+
+  // a random tenth of the world gains or loses Tag and Health every frame
+  std::vector<bool> tagged(count, false);
+  report("churn", backend, count, n * perFrame * 2, measureMs([&] {
+           for (size_t frame{0}; frame < n; ++frame) {
+             for (size_t k{0}; k < perFrame; ++k) {
+               const size_t i = rng() % count;
+               if (tagged[i]) {
+                 centralizer.removeComponent<Tag>(entities[i]);
+                 centralizer.removeComponent<Health>(entities[i]);
+               } else {
+                 centralizer.addComponent(entities[i], Tag{});
+                 centralizer.addComponent(entities[i], Health{1});
+               }
+               tagged[i] = !tagged[i];
+             }
+           }
+         }));
+
+  // same through a CommandBuffer, every entity moves once per flush
+  ecs::CommandBuffer commands{centralizer};
+  report("churn_command_buffer", backend, count, n * perFrame * 2, measureMs([&] {
+           for (size_t frame{0}; frame < n; ++frame) {
+             for (size_t k{0}; k < perFrame; ++k) {
+               const size_t i = rng() % count;
+               if (tagged[i]) {
+                 commands.removeComponent<Tag>(entities[i]);
+                 commands.removeComponent<Health>(entities[i]);
+               } else {
+                 commands.addComponent(entities[i], Tag{});
+                 commands.addComponent(entities[i], Health{1});
+               }
+               tagged[i] = !tagged[i];
+             }
+             commands.flush();
+           }
+         }));
+}
+
+void benchDispatch(ecs::StorageBackend backend, size_t count) {
+  ecs::Centralizer centralizer{backend};
+  registerComponents(centralizer);
+  spawn(centralizer, count);
+  ecs::JobSystem &jobs = centralizer.getJobSystem();
+  ecs::Scheduler scheduler{jobs};
+  const size_t n = frames(count);
+
+  // movement writes Position, two readers of Position wait for it, Health is independent
+  const ecs::Signature position = ecs::componentSignature<Position>();
+  const ecs::Signature velocity = ecs::componentSignature<Velocity>();
+  const ecs::Signature health = ecs::componentSignature<Health>();
+  float sink[2]{};
+  report("dispatch", backend, count, n * count * 3, measureMs([&] {
+           for (size_t frame{0}; frame < n; ++frame) {
+             scheduler.add(velocity, position, [&] {
+               jobs.parallelFor(centralizer.view<Position, Velocity>(), CHUNK_SIZE,
+                                [](ecs::Entity, Position &p, Velocity &v) {
+                                  p.value[0] += v.value[0] * DT;
+                                });
+             });
+             for (float &out : sink) {
+               scheduler.add(position, {}, [&] {
+                 centralizer.view<Position>().each(
+                     [&](ecs::Entity, Position &p) { out += p.value[0]; });
+               });
+             }
+             scheduler.add({}, health, [&] {
+               centralizer.view<Health>().each([](ecs::Entity, Health &h) { --h.value; });
+             });
+             scheduler.run();
+           }
+         }));
+  if (sink[0] != sink[1]) {
+    std::printf("  dispatch readers disagree\n");
+  }
+}
+
+void writeJson(const char *path) {
+  FILE *file = std::fopen(path, "w");
+  if (!file) {
+    std::fprintf(stderr, "can't write %s\n", path);
+    return;
+  }
+  std::fprintf(file, "[\n");
+  for (size_t i{0}; i < gResults.size(); ++i) {
+    const Result &r = gResults[i];
+    std::fprintf(file,
+                 "  {\"name\": \"%s\", \"backend\": \"%s\", \"entities\": %zu, "
+                 "\"operations\": %zu, \"ms\": %.4f, \"ns_per_op\": %.4f}%s\n",
+                 r.name.c_str(), r.backend, r.entities, r.operations, r.ms,
+                 r.ms * 1e6 / r.operations, i + 1 < gResults.size() ? "," : "");
+  }
+  std::fprintf(file, "]\n");
+  std::fclose(file);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const char *json{nullptr};
+  size_t maxEntities = SIZES[std::size(SIZES) - 1];
+  for (int i{1}; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--json") == 0) {
+      json = argv[i + 1];
+    } else if (std::strcmp(argv[i], "--max") == 0) {
+      maxEntities = std::strtoull(argv[i + 1], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--filter") == 0) {
+      gFilter = argv[i + 1];
+    }
+  }
+
+  using Bench = void (*)(ecs::StorageBackend, size_t);
+  const std::pair<const char *, Bench> benches[] = {
+      {"create_destroy", benchCreateDestroy}, {"add_remove", benchAddRemove},
+      {"iteration", benchIteration},          {"churn", benchChurn},
+      {"dispatch", benchDispatch},
+  };
+
+  for (size_t count : SIZES) {
+    if (count > maxEntities) {
+      break;
+    }
+    for (ecs::StorageBackend backend :
+         {ecs::StorageBackend::SparseSet, ecs::StorageBackend::Archetype}) {
+      std::printf("%s backend, %zu entities\n", backendName(backend), count);
+      for (const auto &[name, bench] : benches) {
+        if (enabled(name)) {
+          bench(backend, count);
+        }
+      }
+    }
+  }
+
+  if (json) {
+    writeJson(json);
+  }
+  return 0;
+}
@@ -0,0 +1,144 @@
+// Gravity integration on one core: per entity AoS update against the SoA kernel of
+// gravity_kernel.hpp, with the positions published through a view like the GravitySystem
+// SoA mode does, and alone on the arrays.
+// Build the `gravity_kernel_bench` target and run it, no window or device needed.
+
+#include "../src/ECS/Base/centralizer.hpp"
+#include "../src/ECS/Systems/gravity_kernel.hpp"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+struct Position {
+  float value[3];
+};
+
+struct Body {
+  float velocity[3];
+  float acceleration[3];
+  float mass;
+};
+
+struct Force {
+  float value[3];
+};
+
+constexpr size_t SIZES[] = {100'000, 500'000};
+constexpr size_t UPDATES = 20'000'000;
+constexpr float DT = 1.f / 60.f;
+
+template <typename F> double measureMs(F &&f) {
+  auto start = std::chrono::high_resolution_clock::now();
+  f();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void report(const char *name, double ms, size_t frames) {
+  std::printf("  %-28s %10.3fms (%8.2fus/frame)\n", name, ms, ms * 1000.0 / frames);
+}
+
+void bench(ecs::StorageBackend backend, size_t count) {
+  ecs::Centralizer centralizer{backend};
+  centralizer.registerComponent<Position>();
+  centralizer.registerComponent<Body>();
+  centralizer.registerComponent<Force>();
+  centralizer.createEntities(count, ecs::makePrefab(Position{{0.f, 30.f, 0.f}},
+                                                    Body{{}, {}, 1.f}, Force{{0.f, 0.1485f, 0.f}}));
+
+  const size_t frames = std::max<size_t>(UPDATES / count, 1);
+  std::printf("%s backend, %zu bodies, %zu frames\n",
+              backend == ecs::StorageBackend::Archetype ? "archetype" : "sparse set", count,
+              frames);
+
+  report("per entity", measureMs([&] {
+           for (size_t frame{0}; frame < frames; ++frame) {
+             centralizer.view<Force, Body, Position>().each(
+                 [](ecs::Entity, Force &force, Body &body, Position &position) {
+                   for (int k{0}; k < 3; ++k) {
+                     body.acceleration[k] -= force.value[k] * body.mass;
+                     body.velocity[k] += body.acceleration[k] * DT;
+                     position.value[k] += body.velocity[k] * DT;
+                   }
+                 });
+           }
+         }),
+         frames);
+
+  // GravitySystem SoA mode in steady state: integrate the arrays, then publish positions
+  std::vector<float> position[3], velocity[3], acceleration[3], force[3];
+  std::vector<float> mass;
+  std::vector<uint32_t> slots(ecs::MAX_ENTITIES, 0);
+  centralizer.view<Force, Body, Position>().each(
+      [&](ecs::Entity e, Force &f, Body &body, Position &p) {
+        slots[ecs::entityIndex(e)] = static_cast<uint32_t>(mass.size());
+        for (int k{0}; k < 3; ++k) {
+          position[k].push_back(p.value[k]);
+          velocity[k].push_back(body.velocity[k]);
+          acceleration[k].push_back(body.acceleration[k]);
+          force[k].push_back(f.value[k]);
+        }
+        mass.push_back(body.mass);
+      });
+
+  report("SoA kernel + positions", measureMs([&] {
+           for (size_t frame{0}; frame < frames; ++frame) {
+             for (int k{0}; k < 3; ++k) {
+               ecs::integrateBodies({position[k].data(), velocity[k].data(),
+                                     acceleration[k].data(), force[k].data()},
+                                    mass.data(), count, DT);
+             }
+             centralizer.view<Force, Body, Position>().each(
+                 [&](ecs::Entity e, Force &, Body &, Position &p) {
+                   const uint32_t slot = slots[ecs::entityIndex(e)];
+                   for (int k{0}; k < 3; ++k) {
+                     p.value[k] = position[k][slot];
+                   }
+                 });
+           }
+         }),
+         frames);
+}
+
+// Upper bound: the bodies already live in SoA arrays
+void benchArrays(size_t count) {
+  const size_t frames = std::max<size_t>(UPDATES / count, 1);
+  std::vector<float> position[3], velocity[3], acceleration[3], force[3];
+  for (int k{0}; k < 3; ++k) {
+    position[k].assign(count, 0.f);
+    velocity[k].assign(count, 0.f);
+    acceleration[k].assign(count, 0.f);
+    force[k].assign(count, k == 1 ? 0.1485f : 0.f);
+  }
+  std::vector<float> mass(count, 1.f);
+
+  std::printf("SoA arrays, %zu bodies, %zu frames\n", count, frames);
+  report(ecs::gravityKernelName(), measureMs([&] {
+           for (size_t frame{0}; frame < frames; ++frame) {
+             for (int k{0}; k < 3; ++k) {
+               ecs::integrateBodies({position[k].data(), velocity[k].data(),
+                                     acceleration[k].data(), force[k].data()},
+                                    mass.data(), count, DT);
+             }
+           }
+         }),
+         frames);
+}
+
+} // namespace
+
+int main() {
+  for (size_t count : SIZES) {
+    bench(ecs::StorageBackend::SparseSet, count);
+    bench(ecs::StorageBackend::Archetype, count);
+    benchArrays(count);
+  }
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+// GravitySystem-like update split with JobSystem::parallelFor, from 1 thread up to every
+// hardware thread, at 10k, 100k and 1M bodies on both storage backends.
+// Build the `job_system_bench` target and run it, no window or device needed.
+
+#include "../src/ECS/Base/centralizer.hpp"
+#include "../src/ECS/Base/job_system.hpp"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace {
+
+struct Position {
+  float value[3];
+};
+
+struct Body {
+  float velocity[3];
+  float acceleration[3];
+  float mass;
+};
+
+struct Force {
+  float value[3];
+};
+
+constexpr size_t SIZES[] = {10'000, 100'000, 1'000'000};
+// about the same amount of work for every size
+constexpr size_t UPDATES = 20'000'000;
+constexpr size_t CHUNK_SIZE = 1024;
+constexpr float DT = 1.f / 60.f;
+
+template <typename F> double measureMs(F &&f) {
+  auto start = std::chrono::high_resolution_clock::now();
+  f();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+inline void integrate(Force &force, Body &body, Position &position, float dt) {
+  for (int k{0}; k < 3; ++k) {
+    body.acceleration[k] -= force.value[k] * body.mass;
+    body.velocity[k] += body.acceleration[k] * dt;
+    position.value[k] += body.velocity[k] * dt;
+  }
+}
+
+void bench(ecs::StorageBackend backend, size_t count, size_t maxThreads) {
+  ecs::Centralizer centralizer{backend};
+  centralizer.registerComponent<Position>();
+  centralizer.registerComponent<Body>();
+  centralizer.registerComponent<Force>();
+
+  centralizer.createEntities(count, ecs::makePrefab(Position{{0.f, 30.f, 0.f}},
+                                                    Body{{}, {}, 1.f}, Force{{0.f, 0.1485f, 0.f}}));
+
+  const size_t frames = std::max<size_t>(UPDATES / count, 1);
+  std::printf("%s backend, %zu bodies, %zu frames\n",
+              backend == ecs::StorageBackend::Archetype ? "archetype" : "sparse set", count,
+              frames);
+
+  double single{0.0};
+  for (size_t threads{1}; threads <= maxThreads; ++threads) {
+    ecs::JobSystem jobs{threads - 1};
+    const double ms = measureMs([&] {
+      for (size_t frame{0}; frame < frames; ++frame) {
+        jobs.parallelFor(centralizer.view<Force, Body, Position>(), CHUNK_SIZE,
+                         [](ecs::Entity, Force &force, Body &body, Position &position) {
+                           integrate(force, body, position, DT);
+                         });
+      }
+    });
+    if (threads == 1) {
+      single = ms;
+    }
+    std::printf("  %2zu threads %10.3fms (%8.2fus/frame) x%.2f\n", threads, ms,
+                ms * 1000.0 / frames, single / ms);
+  }
+}
+
+} // namespace
+
+int main() {
+  const size_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  for (size_t count : SIZES) {
+    bench(ecs::StorageBackend::SparseSet, count, maxThreads);
+    bench(ecs::StorageBackend::Archetype, count, maxThreads);
+  }
+
+  return 0;
+}
@@ -0,0 +1,97 @@
+// Building a scene with addComponent calls or spawnBatch against loading it from a Snapshot,
+// on both storage backends.
+// Build the `snapshot_bench` target and run it, no window or device needed.
+
+#include "../src/ECS/Base/snapshot.hpp"
+
+// std
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <tuple>
+
+namespace {
+
+struct Position {
+  float value[3];
+};
+
+struct Body {
+  float velocity[3];
+  float acceleration[3];
+  float mass;
+};
+
+struct Tint {
+  float value[4];
+};
+
+constexpr size_t SIZES[] = {100'000, 1'000'000};
+const std::string PATH = "snapshot_bench.bin";
+
+template <typename F> double measureMs(F &&f) {
+  auto start = std::chrono::high_resolution_clock::now();
+  f();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void registerComponents(ecs::Centralizer &centralizer, ecs::Snapshot &snapshot) {
+  centralizer.registerComponent<Position>();
+  centralizer.registerComponent<Body>();
+  centralizer.registerComponent<Tint>();
+  snapshot.registerComponent<Position>("Position");
+  snapshot.registerComponent<Body>("Body");
+  snapshot.registerComponent<Tint>("Tint");
+}
+
+void bench(ecs::StorageBackend backend, size_t count) {
+  std::printf("%s backend, %zu entities\n",
+              backend == ecs::StorageBackend::Archetype ? "archetype" : "sparse set", count);
+
+  {
+    ecs::Centralizer centralizer{backend};
+    ecs::Snapshot snapshot{centralizer};
+    registerComponents(centralizer, snapshot);
+    std::printf("  %-28s %10.3fms\n", "addComponent", measureMs([&] {
+                  for (size_t i{0}; i < count; ++i) {
+                    ecs::Entity e = centralizer.createEntity();
+                    centralizer.addComponent(e, Position{{float(i), 0.f, 0.f}});
+                    centralizer.addComponent(e, Body{{}, {}, 1.f});
+                    centralizer.addComponent(e, Tint{{1.f, 1.f, 1.f, 1.f}});
+                  }
+                }));
+  }
+
+  ecs::Centralizer centralizer{backend};
+  ecs::Snapshot snapshot{centralizer};
+  registerComponents(centralizer, snapshot);
+  std::printf("  %-28s %10.3fms\n", "spawnBatch", measureMs([&] {
+                centralizer.spawnBatch<Position, Body, Tint>(count, [](size_t i) {
+                  return std::tuple{Position{{float(i), 0.f, 0.f}}, Body{{}, {}, 1.f},
+                                    Tint{{1.f, 1.f, 1.f, 1.f}}};
+                });
+              }));
+  std::printf("  %-28s %10.3fms\n", "save", measureMs([&] { snapshot.save(PATH); }));
+
+  ecs::Centralizer loaded{backend};
+  ecs::Snapshot loader{loaded};
+  registerComponents(loaded, loader);
+  bool ok{false};
+  std::printf("  %-28s %10.3fms\n", "load", measureMs([&] { ok = loader.load(PATH); }));
+  if (!ok) {
+    std::printf("  load failed\n");
+  }
+  std::remove(PATH.c_str());
+}
+
+} // namespace
+
+int main() {
+  for (size_t count : SIZES) {
+    bench(ecs::StorageBackend::SparseSet, count);
+    bench(ecs::StorageBackend::Archetype, count);
+  }
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+// GravitySystem-like update through System::mEntities + getComponent against Centralizer::view
+// and Centralizer::group, on both storage backends.
+// Build the `view_bench` target and run it, no window or device needed.
+
+#include "../src/ECS/Base/centralizer.hpp"
+
+// std
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+struct Position {
+  float value[3];
+};
+
+struct Body {
+  float velocity[3];
+  float acceleration[3];
+  float mass;
+};
+
+struct Force {
+  float value[3];
+};
+
+class LookupSystem : public ecs::System {};
+
+constexpr ecs::Entity ENTITIES = 5000;
+constexpr int FRAMES = 1000;
+constexpr float DT = 1.f / 60.f;
+
+template <typename F> double measureMs(F &&f) {
+  auto start = std::chrono::high_resolution_clock::now();
+  f();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+inline void integrate(Force &force, Body &body, Position &position, float dt) {
+  for (int k{0}; k < 3; ++k) {
+    body.acceleration[k] -= force.value[k] * body.mass;
+    body.velocity[k] += body.acceleration[k] * dt;
+    position.value[k] += body.velocity[k] * dt;
+  }
+}
+
+void report(const char *name, double ms) {
+  std::printf("  %-36s %10.3fms (%.2fus/frame)\n", name, ms, ms * 1000.0 / FRAMES);
+}
+
+void bench(ecs::StorageBackend backend) {
+  ecs::Centralizer centralizer{backend};
+  centralizer.registerComponent<Position>();
+  centralizer.registerComponent<Body>();
+  centralizer.registerComponent<Force>();
+
+  std::shared_ptr<LookupSystem> system = centralizer.registerSystem<LookupSystem>();
+  ecs::Signature signature;
+  signature.set(centralizer.getComponentType<Position>());
+  signature.set(centralizer.getComponentType<Body>());
+  signature.set(centralizer.getComponentType<Force>());
+  centralizer.setSystemSignature<LookupSystem>(signature);
+
+  // same shape as the App scene: every body is also rendered, not everything rendered falls
+  size_t count{0};
+  double create = measureMs([&] {
+    for (ecs::Entity i{0}; i < ENTITIES; ++i) {
+      ecs::Entity e = centralizer.createEntity();
+      centralizer.addComponent(e, Position{{0.f, 30.f, 0.f}});
+      if (i % 4 != 0) {
+        centralizer.addComponent(e, Body{{}, {}, 1.f});
+        centralizer.addComponent(e, Force{{0.f, 0.1485f, 0.f}});
+        ++count;
+      }
+    }
+  });
+
+  const bool archetype = backend == ecs::StorageBackend::Archetype;
+  std::printf("%s backend, %zu bodies, %d frames\n", archetype ? "archetype" : "sparse set", count,
+              FRAMES);
+  std::printf("  %-36s %10.3fms\n", "create scene", create);
+
+  // membership is only tracked by the sparse set backend
+  if (!archetype) {
+    report("mEntities + getComponent", measureMs([&] {
+             for (int frame{0}; frame < FRAMES; ++frame) {
+               for (const ecs::Entity &e : system->mEntities) {
+                 integrate(centralizer.getComponent<Force>(e), centralizer.getComponent<Body>(e),
+                           centralizer.getComponent<Position>(e), DT);
+               }
+             }
+           }));
+  }
+
+  report("view<Force, Body, Position>", measureMs([&] {
+           for (int frame{0}; frame < FRAMES; ++frame) {
+             centralizer.view<Force, Body, Position>().each(
+                 [&](ecs::Entity, Force &force, Body &body, Position &position) {
+                   integrate(force, body, position, DT);
+                 });
+           }
+         }));
+
+  // the first call packs the bodies at the front of the three pools
+  double pack = measureMs([&] { centralizer.group<Force, Body, Position>(); });
+  if (!archetype) {
+    std::printf("  %-36s %10.3fms\n", "build group", pack);
+  }
+
+  report("group<Force, Body, Position>", measureMs([&] {
+           for (int frame{0}; frame < FRAMES; ++frame) {
+             centralizer.group<Force, Body, Position>().each(
+                 [&](ecs::Entity, Force &force, Body &body, Position &position) {
+                   integrate(force, body, position, DT);
+                 });
+           }
+         }));
+}
+
+} // namespace
+
+int main() {
+  bench(ecs::StorageBackend::SparseSet);
+  bench(ecs::StorageBackend::Archetype);
+
+  return 0;
+}
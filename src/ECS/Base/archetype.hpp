@@ -0,0 +1,232 @@
+#pragma once
+
+#include "../Type/ecs_type.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace ecs {
+
+// What an archetype needs to know to move a component it can't name
+struct ComponentInfo {
+  size_t size{0};
+  size_t align{1};
+  void (*moveConstruct)(void *dst, void *src){nullptr};
+  void (*destroy)(void *ptr){nullptr};
+
+  template <typename T> static ComponentInfo of() {
+    return ComponentInfo{
+        sizeof(T), alignof(T),
+        [](void *dst, void *src) { new (dst) T(std::move(*static_cast<T *>(src))); },
+        [](void *ptr) { static_cast<T *>(ptr)->~T(); }};
+  }
+};
+
+// Every entity sharing the same signature.
+// Rows are stored in fixed-size chunks, each chunk keeps one packed column per
+// component (SoA), the change ticks of each column, and the packed entities of its rows.
+class Archetype {
+public:
+  static constexpr size_t CHUNK_BYTES = 16 * 1024;
+  static constexpr size_t CHUNK_ALIGN = 64;
+
+  struct Chunk {
+    std::byte *data{nullptr};
+    size_t count{0};
+  };
+
+  Archetype(Signature signature, const std::array<ComponentInfo, MAX_COMPONENTS> &infos)
+      : mSignature{signature} {
+    for (size_t type{0}; type < MAX_COMPONENTS; ++type) {
+      if (signature.test(type)) {
+        assert(infos[type].size != 0 && "Archetype : Component type not registered.");
+        mColumns.push_back(Column{static_cast<ComponentType>(type), infos[type], 0, 0});
+      }
+    }
+    mColumnIndex.fill(NO_COLUMN);
+    for (size_t i{0}; i < mColumns.size(); ++i) {
+      mColumnIndex[mColumns[i].type] = i;
+    }
+    computeLayout();
+  }
+
+  ~Archetype() {
+    for (Chunk &chunk : mChunks) {
+      for (const Column &column : mColumns) {
+        for (size_t i{0}; i < chunk.count; ++i) {
+          column.info.destroy(chunk.data + column.offset + i * column.info.size);
+        }
+      }
+      ::operator delete(chunk.data, std::align_val_t{CHUNK_ALIGN});
+    }
+  }
+
+  Archetype(const Archetype &) = delete;
+  Archetype &operator=(const Archetype &) = delete;
+
+  Signature signature() const { return mSignature; }
+  size_t size() const { return mSize; }
+  bool hasColumn(ComponentType type) const { return mColumnIndex[type] != NO_COLUMN; }
+
+  size_t memoryUsage() const {
+    return mChunks.size() * CHUNK_BYTES + mChunks.capacity() * sizeof(Chunk) +
+           mColumns.capacity() * sizeof(Column);
+  }
+
+  size_t chunkCount() const { return mChunks.size(); }
+  size_t chunkCapacity() const { return mChunkCapacity; }
+  size_t chunkSize(size_t chunk) const { return mChunks[chunk].count; }
+
+  Entity *entities(size_t chunk) { return reinterpret_cast<Entity *>(mChunks[chunk].data); }
+
+  template <typename T> T *column(size_t chunk, ComponentType type) {
+    assert(hasColumn(type) && "column : Component isn't part of the archetype.");
+    return reinterpret_cast<T *>(mChunks[chunk].data + mColumns[mColumnIndex[type]].offset);
+  }
+
+  ComponentTicks *ticks(size_t chunk, ComponentType type) {
+    assert(hasColumn(type) && "ticks : Component isn't part of the archetype.");
+    return reinterpret_cast<ComponentTicks *>(mChunks[chunk].data +
+                                              mColumns[mColumnIndex[type]].ticksOffset);
+  }
+
+  ComponentTicks &ticksAt(size_t row, ComponentType type) {
+    assert(hasColumn(type) && "ticksAt : Component isn't part of the archetype.");
+    const Column &column = mColumns[mColumnIndex[type]];
+    return reinterpret_cast<ComponentTicks *>(rowData(row) +
+                                              column.ticksOffset)[row % mChunkCapacity];
+  }
+
+  void *componentAt(size_t row, ComponentType type) {
+    assert(hasColumn(type) && "componentAt : Component isn't part of the archetype.");
+    const Column &column = mColumns[mColumnIndex[type]];
+    return rowData(row) + column.offset + (row % mChunkCapacity) * column.info.size;
+  }
+
+  // Append a row for the entity, its components are left unconstructed
+  size_t pushRow(Entity entity) {
+    if (mSize == mChunks.size() * mChunkCapacity) {
+      auto *data =
+          static_cast<std::byte *>(::operator new(CHUNK_BYTES, std::align_val_t{CHUNK_ALIGN}));
+      mChunks.push_back(Chunk{data, 0});
+    }
+    Chunk &chunk = mChunks[mSize / mChunkCapacity];
+    reinterpret_cast<Entity *>(chunk.data)[chunk.count] = entity;
+    ++chunk.count;
+
+    return mSize++;
+  }
+
+  // Swap the last row into the removed one. Return the entity now living at `row`,
+  // or INVALID_ENTITY when the removed row was the last one.
+  Entity removeRow(size_t row) {
+    assert(row < mSize && "removeRow : Row out of range.");
+
+    const size_t last = mSize - 1;
+    Entity moved = INVALID_ENTITY;
+    for (const Column &column : mColumns) {
+      void *removed = componentAt(row, column.type);
+      column.info.destroy(removed);
+      if (row != last) {
+        void *lastData = componentAt(last, column.type);
+        column.info.moveConstruct(removed, lastData);
+        column.info.destroy(lastData);
+        ticksAt(row, column.type) = ticksAt(last, column.type);
+      }
+    }
+    if (row != last) {
+      moved = entityAt(last);
+      entityAt(row) = moved;
+    }
+
+    --mChunks[last / mChunkCapacity].count;
+    --mSize;
+    releaseEmptyChunk();
+
+    return moved;
+  }
+
+  // Move-construct every column shared with `other` from its row into ours, ticks included
+  void moveRowFrom(Archetype &other, size_t otherRow, size_t row) {
+    for (const Column &column : mColumns) {
+      if (other.hasColumn(column.type)) {
+        column.info.moveConstruct(componentAt(row, column.type),
+                                  other.componentAt(otherRow, column.type));
+        ticksAt(row, column.type) = other.ticksAt(otherRow, column.type);
+      }
+    }
+  }
+
+  // Cached transitions to the neighbouring archetypes, filled by ArchetypeStorage
+  std::array<Archetype *, MAX_COMPONENTS> mAddEdges{};
+  std::array<Archetype *, MAX_COMPONENTS> mRemoveEdges{};
+
+private:
+  static constexpr size_t NO_COLUMN = MAX_COMPONENTS;
+
+  struct Column {
+    ComponentType type;
+    ComponentInfo info;
+    size_t offset;
+    size_t ticksOffset;
+  };
+
+  static size_t alignUp(size_t value, size_t align) { return (value + align - 1) / align * align; }
+
+  size_t layoutBytes(size_t capacity) {
+    size_t offset = capacity * sizeof(Entity);
+    for (Column &column : mColumns) {
+      offset = alignUp(offset, column.info.align);
+      column.offset = offset;
+      offset += capacity * column.info.size;
+      offset = alignUp(offset, alignof(ComponentTicks));
+      column.ticksOffset = offset;
+      offset += capacity * sizeof(ComponentTicks);
+    }
+    return offset;
+  }
+
+  void computeLayout() {
+    size_t rowBytes = sizeof(Entity);
+    for (const Column &column : mColumns) {
+      rowBytes += column.info.size + sizeof(ComponentTicks);
+    }
+
+    // start from the ideal row count, shrink until the alignment padding fits too
+    mChunkCapacity = std::max<size_t>(CHUNK_BYTES / rowBytes, 1);
+    while (mChunkCapacity > 1 && layoutBytes(mChunkCapacity) > CHUNK_BYTES) {
+      --mChunkCapacity;
+    }
+    assert(layoutBytes(mChunkCapacity) <= CHUNK_BYTES && "Archetype : Row too big for a chunk.");
+  }
+
+  std::byte *rowData(size_t row) { return mChunks[row / mChunkCapacity].data; }
+
+  Entity &entityAt(size_t row) {
+    return reinterpret_cast<Entity *>(rowData(row))[row % mChunkCapacity];
+  }
+
+  void releaseEmptyChunk() {
+    // keep one spare chunk around so an entity bouncing on a chunk edge doesn't reallocate
+    if (mChunks.size() >= 2 && mChunks.back().count == 0 &&
+        mChunks[mChunks.size() - 2].count == 0) {
+      ::operator delete(mChunks.back().data, std::align_val_t{CHUNK_ALIGN});
+      mChunks.pop_back();
+    }
+  }
+
+  Signature mSignature;
+  std::vector<Column> mColumns{};
+  std::array<size_t, MAX_COMPONENTS> mColumnIndex{};
+  std::vector<Chunk> mChunks{};
+  size_t mChunkCapacity{1};
+  size_t mSize{0};
+};
+
+} // namespace ecs
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "../Type/ecs_type.hpp"
+#include "archetype.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ecs {
+
+// Storage backend grouping entities by signature, see Archetype.
+// Adding or removing a component moves the entity row to the neighbouring archetype.
+class ArchetypeStorage {
+public:
+  ArchetypeStorage() { mRoot = getArchetype(Signature{}); }
+
+  template <typename T> void registerComponent(ComponentType type) {
+    assert(mInfos[type].size == 0 && "registerComponent : Type already registered.");
+    mInfos[type] = ComponentInfo::of<T>();
+  }
+
+  // Every entity starts in the archetype without any component
+  void createEntity(Entity entity) {
+    const Entity index = entityIndex(entity);
+    if (index >= mLocations.size()) {
+      mLocations.resize(index + 1);
+    }
+    assert(mLocations[index].archetype == nullptr &&
+           "createEntity : Entity is already in the storage.");
+    mLocations[index] = {mRoot, mRoot->pushRow(entity)};
+  }
+
+  // Place new entities straight in the archetype of the signature,
+  // their components are left unconstructed, fill them with constructComponent
+  void createEntities(const Entity *entities, size_t count, Signature signature) {
+    Archetype *archetype = getArchetype(signature);
+    Entity last{0};
+    for (size_t i{0}; i < count; ++i) {
+      last = std::max(last, entityIndex(entities[i]));
+    }
+    if (count > 0 && last >= mLocations.size()) {
+      mLocations.resize(last + 1);
+    }
+
+    for (size_t i{0}; i < count; ++i) {
+      const Entity index = entityIndex(entities[i]);
+      assert(mLocations[index].archetype == nullptr &&
+             "createEntities : Entity is already in the storage.");
+      mLocations[index] = {archetype, archetype->pushRow(entities[i])};
+    }
+  }
+
+  void destroyEntity(Entity entity) {
+    EntityLocation &location = getLocation(entity);
+    removeRow(*location.archetype, location.row);
+    location = {};
+  }
+
+  template <typename T>
+  void addComponent(Entity entity, ComponentType type, T component, Tick tick) {
+    EntityLocation &location = getLocation(entity);
+    assert(!location.archetype->hasColumn(type) &&
+           "addComponent : Entity already owns this component.");
+
+    Archetype &target = getAddEdge(*location.archetype, type);
+    size_t row = moveEntity(entity, target);
+    new (target.componentAt(row, type)) T(std::move(component));
+    target.ticksAt(row, type) = ComponentTicks{tick, tick};
+  }
+
+  void removeComponent(Entity entity, ComponentType type) {
+    EntityLocation &location = getLocation(entity);
+    assert(location.archetype->hasColumn(type) &&
+           "removeComponent : Entity doesn't own this component.");
+
+    moveEntity(entity, getRemoveEdge(*location.archetype, type));
+  }
+
+  // Move the entity straight to the archetype of the signature. Columns it didn't own
+  // are left unconstructed, fill them with constructComponent.
+  void migrate(Entity entity, Signature signature) {
+    if (getLocation(entity).archetype->signature() != signature) {
+      moveEntity(entity, *getArchetype(signature));
+    }
+  }
+
+  template <typename T>
+  void constructComponent(Entity entity, ComponentType type, T component, Tick tick) {
+    EntityLocation &location = getLocation(entity);
+    new (location.archetype->componentAt(location.row, type)) T(std::move(component));
+    location.archetype->ticksAt(location.row, type) = ComponentTicks{tick, tick};
+  }
+
+  template <typename T> T &getComponent(Entity entity, ComponentType type) {
+    EntityLocation &location = getLocation(entity);
+    return *static_cast<T *>(location.archetype->componentAt(location.row, type));
+  }
+
+  ComponentTicks &getTicks(Entity entity, ComponentType type) {
+    EntityLocation &location = getLocation(entity);
+    return location.archetype->ticksAt(location.row, type);
+  }
+
+  std::vector<PoolMemoryUsage> getMemoryUsage() const {
+    std::vector<PoolMemoryUsage> usage;
+    for (const auto &archetype : mArchetypes) {
+      usage.push_back({archetype->signature(), archetype->size(), archetype->memoryUsage()});
+    }
+    return usage;
+  }
+
+  // Archetypes owning at least the signature, cached per query signature
+  const std::vector<Archetype *> &getMatching(Signature signature) {
+    Query &query = mQueries[signature];
+    for (; query.seen < mArchetypes.size(); ++query.seen) {
+      Archetype *archetype = mArchetypes[query.seen].get();
+      if ((archetype->signature() & signature) == signature) {
+        query.archetypes.push_back(archetype);
+      }
+    }
+    return query.archetypes;
+  }
+
+private:
+  struct EntityLocation {
+    Archetype *archetype{nullptr};
+    size_t row{0};
+  };
+
+  struct Query {
+    std::vector<Archetype *> archetypes{};
+    size_t seen{0};
+  };
+
+  EntityLocation &getLocation(Entity entity) {
+    const Entity index = entityIndex(entity);
+    assert(index < mLocations.size() && mLocations[index].archetype != nullptr &&
+           "getLocation : Entity isn't in the storage.");
+    return mLocations[index];
+  }
+
+  Archetype *getArchetype(Signature signature) {
+    auto it = mArchetypeBySignature.find(signature);
+    if (it != mArchetypeBySignature.end()) {
+      return it->second;
+    }
+
+    mArchetypes.push_back(std::make_unique<Archetype>(signature, mInfos));
+    Archetype *archetype = mArchetypes.back().get();
+    mArchetypeBySignature.insert({signature, archetype});
+    return archetype;
+  }
+
+  Archetype &getAddEdge(Archetype &from, ComponentType type) {
+    if (!from.mAddEdges[type]) {
+      Archetype *to = getArchetype(Signature{from.signature()}.set(type));
+      from.mAddEdges[type] = to;
+      to->mRemoveEdges[type] = &from;
+    }
+    return *from.mAddEdges[type];
+  }
+
+  Archetype &getRemoveEdge(Archetype &from, ComponentType type) {
+    if (!from.mRemoveEdges[type]) {
+      Archetype *to = getArchetype(Signature{from.signature()}.reset(type));
+      from.mRemoveEdges[type] = to;
+      to->mAddEdges[type] = &from;
+    }
+    return *from.mRemoveEdges[type];
+  }
+
+  // Move the entity row and every shared component, return the new row
+  size_t moveEntity(Entity entity, Archetype &target) {
+    EntityLocation &location = getLocation(entity);
+    Archetype &source = *location.archetype;
+    const size_t sourceRow = location.row;
+
+    const size_t row = target.pushRow(entity);
+    target.moveRowFrom(source, sourceRow, row);
+    removeRow(source, sourceRow);
+
+    location = {&target, row};
+    return row;
+  }
+
+  void removeRow(Archetype &archetype, size_t row) {
+    Entity moved = archetype.removeRow(row);
+    if (moved != INVALID_ENTITY) {
+      mLocations[entityIndex(moved)].row = row;
+    }
+  }
+
+  std::array<ComponentInfo, MAX_COMPONENTS> mInfos{};
+  std::vector<std::unique_ptr<Archetype>> mArchetypes{};
+  std::unordered_map<Signature, Archetype *> mArchetypeBySignature{};
+  std::unordered_map<Signature, Query> mQueries{};
+  std::vector<EntityLocation> mLocations{};
+  Archetype *mRoot{nullptr};
+};
+
+} // namespace ecs
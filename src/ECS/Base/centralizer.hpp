@@ -1,56 +1,296 @@
 #pragma once
 
+#include "archetype_storage.hpp"
 #include "component_manager.hpp"
 #include "entity_manager.hpp"
+#include "group.hpp"
+#include "job_system.hpp"
+#include "observers.hpp"
+#include "prefab.hpp"
 #include "system_manager.hpp"
+#include "view.hpp"
 
 #include "../Type/ecs_type.hpp"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace ecs {
+
+// Where component data lives, picked once when the world is created.
+// SparseSet: one packed array per component type (ComponentArray).
+// Archetype: entities grouped by signature in SoA chunks (ArchetypeStorage).
+// Systems only see their entities through views with the archetype backend,
+// System::mEntities stays empty.
+enum class StorageBackend { SparseSet, Archetype };
+
+// One world: its entities, components, systems and worker pool. Worlds share no state,
+// separate worlds can be updated from separate threads. Systems are handed the world they
+// run on when they are registered.
+// Worlds may share one worker pool instead of starting their own, it has to outlive them.
 class Centralizer {
 public:
-  Centralizer() {
+  explicit Centralizer(StorageBackend backend = StorageBackend::SparseSet) : mBackend{backend} {
     mComponentManager = std::make_unique<ComponentManager>();
     mEntityManager = std::make_unique<EntityManager>();
     mSystemManager = std::make_unique<SystemManager>();
+    if (mBackend == StorageBackend::Archetype) {
+      mArchetypeStorage = std::make_unique<ArchetypeStorage>();
+    }
+  }
+
+  Centralizer(StorageBackend backend, JobSystem &jobSystem) : Centralizer{backend} {
+    mJobSystem = &jobSystem;
+  }
+
+  StorageBackend getStorageBackend() const { return mBackend; }
+
+  // Worker pool shared by the systems, the given one or our own started on first use
+  JobSystem &getJobSystem() {
+    if (mJobSystem) {
+      return *mJobSystem;
+    }
+    std::call_once(mOwnedJobSystemOnce,
+                   [this] { mOwnedJobSystem = std::make_unique<JobSystem>(); });
+    return *mOwnedJobSystem;
+  }
+
+  Entity createEntity() {
+    Entity entity = mEntityManager->createEntity();
+    ++mStructureVersion;
+    if (mArchetypeStorage) {
+      mArchetypeStorage->createEntity(entity);
+    }
+    return entity;
+  }
+
+  // Spawn `count` entities owning the Ts, generator(i) returns the std::tuple<Ts...> of the
+  // i-th entity. Ids are reserved in one go, components are appended in contiguous runs and
+  // systems see the whole batch in a single pass.
+  template <typename... Ts, typename F>
+  std::vector<Entity> spawnBatch(size_t count, F &&generator) {
+    std::vector<Entity> entities(count);
+    mEntityManager->createEntities(entities.data(), count);
+    ++mStructureVersion;
+
+    Signature signature;
+    (signature.set(getComponentType<Ts>()), ...);
+
+    if (mArchetypeStorage) {
+      mArchetypeStorage->createEntities(entities.data(), count, signature);
+      for (size_t i{0}; i < count; ++i) {
+        std::tuple<Ts...> components = generator(i);
+        (mArchetypeStorage->constructComponent<Ts>(entities[i], getComponentType<Ts>(),
+                                                   std::move(std::get<Ts>(components)), mTick),
+         ...);
+      }
+    } else {
+      std::tuple<ComponentArray<Ts> *...> arrays{mComponentManager->getComponentArray<Ts>()...};
+      (std::get<ComponentArray<Ts> *>(arrays)->reserve(count), ...);
+      // the generator fills one column per component, each run is appended in bulk
+      std::tuple<std::vector<Ts>...> columns;
+      (std::get<std::vector<Ts>>(columns).reserve(std::min(count, SPAWN_RUN)), ...);
+      for (size_t begin{0}; begin < count; begin += SPAWN_RUN) {
+        const size_t end = std::min(begin + SPAWN_RUN, count);
+        for (size_t i{begin}; i < end; ++i) {
+          std::tuple<Ts...> components = generator(i);
+          (std::get<std::vector<Ts>>(columns).push_back(std::move(std::get<Ts>(components))),
+           ...);
+        }
+        (std::get<ComponentArray<Ts> *>(arrays)->insertRun(
+             entities.data() + begin, std::get<std::vector<Ts>>(columns).data(), end - begin,
+             mTick),
+         ...);
+        (std::get<std::vector<Ts>>(columns).clear(), ...);
+        for (size_t i{begin}; i < end; ++i) {
+          mComponentManager->joinGroups(entities[i]);
+        }
+      }
+    }
+    (mObservers.record(getComponentType<Ts>(), ComponentEvent::Add, entities.data(), count), ...);
+
+    for (Entity entity : entities) {
+      mEntityManager->setSignature(entity, signature);
+    }
+    if (!mArchetypeStorage) {
+      mSystemManager->entitiesSignatureChanged(entities.data(), count, signature);
+    }
+
+    return entities;
+  }
+
+  // Spawn `count` copies of the prefab
+  template <typename... Ts>
+  std::vector<Entity> createEntities(size_t count, const Prefab<Ts...> &prefab) {
+    return spawnBatch<Ts...>(count, [&prefab](size_t) { return prefab.components; });
   }
 
-  Entity createEntity() { return mEntityManager->createEntity(); }
+  // False once the entity got destroyed, even if its slot is in use again
+  bool isAlive(Entity entity) const { return mEntityManager->isAlive(entity); }
 
   void destroyEntity(Entity entity) {
+    mObservers.record(mEntityManager->getSignature(entity), ComponentEvent::Remove, entity);
     mEntityManager->destroyEntity(entity);
-    mComponentManager->entityDestroyed(entity);
+    ++mStructureVersion;
+    if (mArchetypeStorage) {
+      mArchetypeStorage->destroyEntity(entity);
+    } else {
+      mComponentManager->entityDestroyed(entity);
+    }
     mSystemManager->entityDestroyed(entity);
   }
 
-  template <typename T> void registerComponent() { mComponentManager->registerComponent<T>(); }
+  template <typename T> void registerComponent() {
+    mComponentManager->registerComponent<T>();
+    if (mArchetypeStorage) {
+      mArchetypeStorage->registerComponent<T>(mComponentManager->getComponentType<T>());
+    }
+  }
 
   template <typename T> void addComponent(Entity entity, T component) {
-    mComponentManager->addComponent<T>(entity, component);
+    ++mStructureVersion;
+    if (mArchetypeStorage) {
+      mArchetypeStorage->addComponent<T>(entity, mComponentManager->getComponentType<T>(),
+                                         std::move(component), mTick);
+    } else {
+      mComponentManager->addComponent<T>(entity, std::move(component), mTick);
+    }
 
     Signature signature = mEntityManager->getSignature(entity);
     signature.set(mComponentManager->getComponentType<T>(), true);
     mEntityManager->setSignature(entity, signature);
+    mObservers.record(getComponentType<T>(), ComponentEvent::Add, entity);
 
-    mSystemManager->entitySignatureChanged(entity, signature);
+    if (!mArchetypeStorage) {
+      mSystemManager->entitySignatureChanged(entity, signature);
+    }
   }
 
   template <typename T> void removeComponent(Entity entity) {
-    mComponentManager->removeComponent<T>(entity);
+    ++mStructureVersion;
+    if (mArchetypeStorage) {
+      mArchetypeStorage->removeComponent(entity, mComponentManager->getComponentType<T>());
+    } else {
+      mComponentManager->removeComponent<T>(entity);
+    }
 
     Signature signature = mEntityManager->getSignature(entity);
     signature.set(mComponentManager->getComponentType<T>(), false);
     mEntityManager->setSignature(entity, signature);
+    mObservers.record(getComponentType<T>(), ComponentEvent::Remove, entity);
 
-    mSystemManager->entitySignatureChanged(entity, signature);
+    if (!mArchetypeStorage) {
+      mSystemManager->entitySignatureChanged(entity, signature);
+    }
   }
 
   template <typename T> T &getComponent(Entity entity) {
+    if (mArchetypeStorage) {
+      return mArchetypeStorage->getComponent<T>(entity, mComponentManager->getComponentType<T>());
+    }
     return mComponentManager->getComponent<T>(entity);
   }
 
+  template <typename T> bool hasComponent(Entity entity) const {
+    return mEntityManager->getSignature(entity).test(mComponentManager->getComponentType<T>());
+  }
+
+  // Bumped by every entity creation or destruction, every component added or removed and
+  // every group built. References to components taken at an older version may be dangling.
+  std::uint64_t getStructureVersion() const { return mStructureVersion; }
+
+  Tick getTick() const { return mTick; }
+
+  // Start a new frame of change detection, returns the new tick
+  Tick advanceTick() { return ++mTick; }
+
+  template <typename T> ComponentTicks getComponentTicks(Entity entity) {
+    return getTicks<T>(entity);
+  }
+
+  // Flag the component as written during the current tick, see View::changedSince, and
+  // report it to the onUpdate observers. A reader running several times within one tick
+  // sees the writes of that tick again, nothing tells them apart.
+  // Safe from parallel jobs as long as each entity is marked by a single job.
+  template <typename T> void markChanged(Entity entity) {
+    getTicks<T>(entity).changed = mTick;
+    mObservers.record(getComponentType<T>(), ComponentEvent::Update, entity);
+  }
+
+  // fn(T &) then markChanged<T>
+  template <typename T, typename F> void patch(Entity entity, F &&fn) {
+    fn(getComponent<T>(entity));
+    markChanged<T>(entity);
+  }
+
+  // Observers of the T events, called by dispatchEvents() with the entities that got a T
+  // added, removed or updated (see markChanged) since the previous dispatch.
+  // Connect them before the systems start running.
+  template <typename T> void onAdd(Observer observer) {
+    mObservers.connect(getComponentType<T>(), ComponentEvent::Add, std::move(observer));
+  }
+
+  template <typename T> void onRemove(Observer observer) {
+    mObservers.connect(getComponentType<T>(), ComponentEvent::Remove, std::move(observer));
+  }
+
+  template <typename T> void onUpdate(Observer observer) {
+    mObservers.connect(getComponentType<T>(), ComponentEvent::Update, std::move(observer));
+  }
+
+  // Sync point: hand the events collected so far to the observers, in batches.
+  // Additions and updates only list entities still owning the component, removals may list
+  // destroyed entities. Call it from one thread, outside of any system update.
+  void dispatchEvents() {
+    mObservers.dispatch([this](ComponentType type, Entity entity) {
+      return isAlive(entity) && mEntityManager->getSignature(entity).test(type);
+    });
+  }
+
+  // Iterate every entity owning all the Ts, see View
+  template <typename... Ts> View<Ts...> view() {
+    if (mArchetypeStorage) {
+      std::array<ComponentType, sizeof...(Ts)> types{mComponentManager->getComponentType<Ts>()...};
+      Signature signature;
+      for (ComponentType type : types) {
+        signature.set(type);
+      }
+      return View<Ts...>{mArchetypeStorage->getMatching(signature), types};
+    }
+    return View<Ts...>{mComponentManager->getComponentArray<Ts>()...};
+  }
+
+  // Entities owning all the Ts, packed at the front of each of their component arrays so a
+  // walk is a linear scan of every array, see Group. The first call builds the group, it is
+  // maintained on every add, remove and destroy from then on.
+  template <typename... Ts> Group<Ts...> group() {
+    if (mArchetypeStorage) {
+      return Group<Ts...>{view<Ts...>()};
+    }
+    const size_t groupCount = mComponentManager->getGroupCount();
+    OwnedGroup &owned = mComponentManager->getGroup<Ts...>();
+    // building the group swapped slots in the arrays it owns
+    if (mComponentManager->getGroupCount() != groupCount) {
+      ++mStructureVersion;
+    }
+    return Group<Ts...>{owned, mComponentManager->getComponentArray<Ts>()...};
+  }
+
+  // One entry per component array, or per archetype with the archetype backend
+  std::vector<PoolMemoryUsage> getMemoryUsage() const {
+    if (mArchetypeStorage) {
+      return mArchetypeStorage->getMemoryUsage();
+    }
+    return mComponentManager->getMemoryUsage();
+  }
+
   template <typename T> ComponentType getComponentType() {
     return mComponentManager->getComponentType<T>();
   }
@@ -64,8 +304,134 @@ public:
   }
 
 private:
+  friend class CommandBuffer;
+  friend class Snapshot;
+
+  // entities generated per run by spawnBatch with the sparse set backend
+  static constexpr size_t SPAWN_RUN = 1024;
+
+  // Storage only, CommandBuffer updates signatures and systems once per entity afterwards.
+  // `owned` tells if the entity already had the component before the flush.
+  template <typename T> void writeComponentData(Entity entity, T component, bool owned) {
+    if (owned) {
+      getComponent<T>(entity) = std::move(component);
+      markChanged<T>(entity);
+      return;
+    }
+
+    if (mArchetypeStorage) {
+      mArchetypeStorage->constructComponent<T>(entity, getComponentType<T>(),
+                                               std::move(component), mTick);
+    } else {
+      mComponentManager->addComponent<T>(entity, std::move(component), mTick);
+    }
+    mObservers.record(getComponentType<T>(), ComponentEvent::Add, entity);
+  }
+
+  // Move the entity data to its final signature and publish it
+  void applySignature(Entity entity, Signature signature) {
+    const Signature previous = mEntityManager->getSignature(entity);
+    ++mStructureVersion;
+    mObservers.record(previous & ~signature, ComponentEvent::Remove, entity);
+    if (mArchetypeStorage) {
+      mArchetypeStorage->migrate(entity, signature);
+    } else {
+      for (size_t type{0}; type < MAX_COMPONENTS; ++type) {
+        if (previous.test(type) && !signature.test(type)) {
+          mComponentManager->removeComponent(entity, static_cast<ComponentType>(type));
+        }
+      }
+    }
+    mEntityManager->setSignature(entity, signature);
+  }
+
+  void publishSignature(Entity entity, Signature signature) {
+    if (!mArchetypeStorage) {
+      mSystemManager->entitySignatureChanged(entity, signature);
+    }
+  }
+
+  Signature getSignature(Entity entity) const { return mEntityManager->getSignature(entity); }
+
+  // Thread safe, see EntityManager::reserveEntity
+  Entity reserveEntity() { return mEntityManager->reserveEntity(); }
+
+  // The reserved entity joins the world, without component
+  void createReserved(Entity entity) {
+    mEntityManager->createReserved(entity);
+    ++mStructureVersion;
+    if (mArchetypeStorage) {
+      mArchetypeStorage->createEntity(entity);
+    }
+  }
+
+  // The reserved entity will never be created
+  void releaseReserved(Entity entity) { mEntityManager->releaseReserved(entity); }
+
+  // Snapshot loading: slots and signatures first, then every component section, then
+  // systems and groups once per entity. signatures[i] belongs to living[i].
+  void restoreEntities(const Entity *generations, size_t slotCount, const Entity *living,
+                       const Signature *signatures, size_t livingCount) {
+    mEntityManager->restore(generations, slotCount, living, livingCount);
+    ++mStructureVersion;
+
+    for (size_t begin{0}, end{0}; begin < livingCount; begin = end) {
+      end = begin;
+      while (end < livingCount && signatures[end] == signatures[begin]) {
+        mEntityManager->setSignature(living[end], signatures[end]);
+        ++end;
+      }
+      // runs of one signature land in their archetype in one go
+      if (mArchetypeStorage) {
+        mArchetypeStorage->createEntities(living + begin, end - begin, signatures[begin]);
+      }
+    }
+  }
+
+  // `values` holds the packed components of the entities as raw bytes
+  template <typename T>
+  void restoreComponents(const Entity *entities, const std::byte *values, size_t count) {
+    if (mArchetypeStorage) {
+      for (size_t i{0}; i < count; ++i) {
+        T component;
+        std::memcpy(&component, values + i * sizeof(T), sizeof(T));
+        mArchetypeStorage->constructComponent<T>(entities[i], getComponentType<T>(), component,
+                                                 mTick);
+      }
+    } else {
+      mComponentManager->getComponentArray<T>()->insertBatch(entities, values, count, mTick);
+    }
+    mObservers.record(getComponentType<T>(), ComponentEvent::Add, entities, count);
+  }
+
+  void publishRestored(const Entity *living, size_t livingCount) {
+    if (mArchetypeStorage) {
+      return;
+    }
+    for (size_t i{0}; i < livingCount; ++i) {
+      mComponentManager->joinGroups(living[i]);
+      mSystemManager->entitySignatureChanged(living[i], getSignature(living[i]));
+    }
+  }
+
+  template <typename T> ComponentTicks &getTicks(Entity entity) {
+    if (mArchetypeStorage) {
+      return mArchetypeStorage->getTicks(entity, mComponentManager->getComponentType<T>());
+    }
+    return mComponentManager->getTicks<T>(entity);
+  }
+
+  StorageBackend mBackend;
   std::unique_ptr<ComponentManager> mComponentManager;
   std::unique_ptr<EntityManager> mEntityManager;
   std::unique_ptr<SystemManager> mSystemManager;
+  std::unique_ptr<ArchetypeStorage> mArchetypeStorage{};
+  Tick mTick{1};
+  std::uint64_t mStructureVersion{0};
+  Observers mObservers{};
+
+  JobSystem *mJobSystem{nullptr};
+  std::once_flag mOwnedJobSystemOnce;
+  std::unique_ptr<JobSystem> mOwnedJobSystem{};
 };
-} // namespace ecs
\ No newline at end of file
+} // namespace ecs
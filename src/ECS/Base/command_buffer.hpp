@@ -0,0 +1,168 @@
+#pragma once
+
+#include "../Type/ecs_type.hpp"
+#include "../Type/type_id.hpp"
+#include "centralizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ecs {
+
+// Records structural changes and applies them later in one flush().
+// Creation only reserves the handle, the entity is created by the flush like
+// destroy / add / remove. flush() sorts the commands by entity, keeps the last
+// add or remove per component (an add on an owned component replaces it), moves
+// every entity once to its final signature and updates systems once per entity.
+// A buffer is not thread safe, give each thread its own. Buffers of one world can
+// record from parallel jobs, they are flushed once no job runs anymore. An entity created
+// through a buffer only exists, for the world and for other buffers, once that buffer got
+// flushed. A buffer destroyed before its flush releases the entities it reserved, so it
+// follows the rules of flush().
+class CommandBuffer {
+public:
+  explicit CommandBuffer(Centralizer &centralizer) : mCentralizer{centralizer} {}
+
+  ~CommandBuffer() {
+    for (const Command &command : mCommands) {
+      if (command.type == CommandType::Create) {
+        mCentralizer.releaseReserved(command.entity);
+      }
+    }
+  }
+
+  CommandBuffer(const CommandBuffer &) = delete;
+  CommandBuffer &operator=(const CommandBuffer &) = delete;
+
+  Entity createEntity() {
+    const Entity entity = mCentralizer.reserveEntity();
+    record(entity, CommandType::Create, 0, 0);
+    return entity;
+  }
+
+  void destroyEntity(Entity entity) { record(entity, CommandType::Destroy, 0, 0); }
+
+  template <typename T> void addComponent(Entity entity, T component) {
+    const ComponentType type = mCentralizer.getComponentType<T>();
+    if (!mPending[type]) {
+      mPending[type] = std::make_unique<PendingComponents<T>>();
+    }
+    auto &pending = static_cast<PendingComponents<T> &>(*mPending[type]);
+    pending.mComponents.push_back(std::move(component));
+    record(entity, CommandType::Add, type, pending.mComponents.size() - 1);
+  }
+
+  template <typename T> void removeComponent(Entity entity) {
+    record(entity, CommandType::Remove, mCentralizer.getComponentType<T>(), 0);
+  }
+
+  bool empty() const { return mCommands.empty(); }
+
+  void flush() {
+    // stable: commands of one entity stay in recording order
+    std::stable_sort(mCommands.begin(), mCommands.end(),
+                     [](const Command &a, const Command &b) { return a.entity < b.entity; });
+
+    for (size_t begin{0}, end{0}; begin < mCommands.size(); begin = end) {
+      end = begin;
+      while (end < mCommands.size() && mCommands[end].entity == mCommands[begin].entity) {
+        ++end;
+      }
+      applyEntity(begin, end);
+    }
+
+    mCommands.clear();
+    for (auto &pending : mPending) {
+      if (pending) {
+        pending->clear();
+      }
+    }
+  }
+
+private:
+  enum class CommandType { Create, Destroy, Add, Remove };
+
+  struct Command {
+    Entity entity;
+    CommandType type;
+    ComponentType component;
+    size_t payload;
+  };
+
+  // Components waiting for a flush, one typed array per component type
+  class IPendingComponents {
+  public:
+    virtual ~IPendingComponents() = default;
+    virtual void write(Centralizer &centralizer, Entity entity, size_t index, bool owned) = 0;
+    virtual void clear() = 0;
+  };
+
+  template <typename T> class PendingComponents : public IPendingComponents {
+  public:
+    void write(Centralizer &centralizer, Entity entity, size_t index, bool owned) override {
+      centralizer.writeComponentData<T>(entity, std::move(mComponents[index]), owned);
+    }
+    void clear() override { mComponents.clear(); }
+
+    std::vector<T> mComponents{};
+  };
+
+  void record(Entity entity, CommandType type, ComponentType component, size_t payload) {
+    mCommands.push_back(Command{entity, type, component, payload});
+  }
+
+  void applyEntity(size_t begin, size_t end) {
+    const Entity entity = mCommands[begin].entity;
+    // recorded first, the stable sort keeps it first
+    if (mCommands[begin].type == CommandType::Create) {
+      mCentralizer.createReserved(entity);
+      ++begin;
+    }
+    // the entity may have been destroyed since the commands got recorded
+    if (!mCentralizer.isAlive(entity)) {
+      return;
+    }
+
+    // last command per component type wins
+    std::array<const Command *, MAX_COMPONENTS> last{};
+    for (size_t i{begin}; i < end; ++i) {
+      if (mCommands[i].type == CommandType::Destroy) {
+        mCentralizer.destroyEntity(entity);
+        return;
+      }
+      last[mCommands[i].component] = &mCommands[i];
+    }
+
+    const Signature previous = mCentralizer.getSignature(entity);
+    Signature signature = previous;
+    for (size_t type{0}; type < MAX_COMPONENTS; ++type) {
+      if (last[type]) {
+        signature.set(type, last[type]->type == CommandType::Add);
+      }
+    }
+
+    // overwriting owned components moves nothing
+    if (signature != previous) {
+      mCentralizer.applySignature(entity, signature);
+    }
+    for (size_t type{0}; type < MAX_COMPONENTS; ++type) {
+      if (last[type] && last[type]->type == CommandType::Add) {
+        mPending[type]->write(mCentralizer, entity, last[type]->payload, previous.test(type));
+      }
+    }
+
+    if (signature != previous) {
+      mCentralizer.publishSignature(entity, signature);
+    }
+  }
+
+  Centralizer &mCentralizer;
+  std::vector<Command> mCommands{};
+  std::array<std::unique_ptr<IPendingComponents>, MAX_COMPONENTS> mPending{};
+};
+
+} // namespace ecs
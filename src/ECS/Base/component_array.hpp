@@ -1,11 +1,12 @@
 #pragma once
 
 #include "../Type/ecs_type.hpp"
+#include "paged_vector.hpp"
+#include "sparse_set.hpp"
 
-#include <array>
 #include <cassert>
-#include <iostream>
-#include <unordered_map>
+#include <cstddef>
+#include <utility>
 
 namespace ecs {
 
@@ -14,56 +15,121 @@ class IComponentArray {
 public:
   virtual ~IComponentArray() = default;
   virtual void entityDestroyed(Entity entity) = 0;
+  virtual void removeData(Entity entity) = 0;
+  virtual size_t size() const = 0;
+  virtual const SparseSet &entities() const = 0;
+  // Exchange the packed slots a and b, data and ticks included
+  virtual void swapSlots(size_t a, size_t b) = 0;
+  // Bytes allocated by the packed data and the sparse index
+  virtual size_t memoryUsage() const = 0;
 };
 
 template <typename T> class ComponentArray : public IComponentArray {
 
 public:
-  void insertData(Entity entity, T component) {
-    assert(mEntityToIndex.find(entity) == mEntityToIndex.end() &&
-           "insertData : Entity is already in the component array.");
+  void insertData(Entity entity, T component, Tick tick) {
+    assert(!mEntities.contains(entity) && "insertData : Entity is already in the component array.");
 
-    // keep the index to data position
-    mEntityToIndex[entity] = currentSize;
-    mIndexToEntity[currentSize] = entity;
+    // packed data, ticks and packed entities always grow together
+    mEntities.insert(entity);
+    mComponentArray.push_back(std::move(component));
+    mTicks.push_back(ComponentTicks{tick, tick});
+  }
+
+  // insertData for `count` entities at once, `values` holds their packed components
+  // as raw bytes (trivially copyable T only)
+  void insertBatch(const Entity *entities, const std::byte *values, size_t count, Tick tick) {
+    mEntities.insert(entities, count);
+    mComponentArray.append(values, count);
+    mTicks.append(count, ComponentTicks{tick, tick});
+  }
 
-    // add the component to the right place
-    mComponentArray[currentSize] = component;
+  // insertData for `count` entities at once, their components are moved out of `values`
+  void insertRun(const Entity *entities, T *values, size_t count, Tick tick) {
+    mEntities.insert(entities, count);
+    mComponentArray.appendMoved(values, count);
+    mTicks.append(count, ComponentTicks{tick, tick});
+  }
 
-    ++currentSize;
+  // Make room for `count` more components in one go
+  void reserve(size_t count) {
+    mComponentArray.reserve(mComponentArray.size() + count);
+    mTicks.reserve(mTicks.size() + count);
+    mEntities.reserve(mEntities.size() + count);
   }
 
-  void removeData(Entity entity) {
-    assert(mEntityToIndex.find(entity) != mEntityToIndex.end() &&
-           "removeData : Entity isn't in the component array.");
+  void removeData(Entity entity) override {
+    assert(mEntities.contains(entity) && "removeData : Entity isn't in the component array.");
 
     // put the last element of the array at the "to remove" entity index
-    size_t removedEntityIndex = mEntityToIndex[entity];
-    size_t LastEntityIndex = currentSize - 1;
-    mComponentArray[removedEntityIndex] = mComponentArray[LastEntityIndex];
+    size_t removedEntityIndex = mEntities.index(entity);
+    size_t lastEntityIndex = mComponentArray.size() - 1;
+    if (removedEntityIndex != lastEntityIndex) {
+      mComponentArray[removedEntityIndex] = std::move(mComponentArray.back());
+      mTicks[removedEntityIndex] = mTicks.back();
+    }
+    mComponentArray.pop_back();
+    mTicks.pop_back();
+
+    // the sparse set does the same swap on its side
+    mEntities.erase(entity);
+  }
 
-    // update map to keep the 1-1 relation between the new index and entity
-    Entity lastElement = mIndexToEntity[removedEntityIndex];
-    mEntityToIndex[lastElement] = removedEntityIndex;
-    mIndexToEntity[removedEntityIndex] = lastElement;
+  T &getData(Entity entity) {
+    assert(mEntities.contains(entity) && "getData : Entity isn't in the component array.");
 
-    --currentSize;
+    return mComponentArray[mEntities.index(entity)];
   }
 
-  T &getData(Entity entity) {
-    assert(mEntityToIndex.find(entity) != mEntityToIndex.end() &&
-           "getData : Entity isn't in the component array.");
+  // Packed access, index is the position in entities()
+  T &getDataAt(size_t index) {
+    assert(index < mComponentArray.size() && "getDataAt : Index out of range.");
 
-    return mComponentArray[mEntityToIndex[entity]];
+    return mComponentArray[index];
   }
 
-  void entityDestroyed(Entity entity) { removeData(entity); }
+  ComponentTicks &getTicks(Entity entity) {
+    assert(mEntities.contains(entity) && "getTicks : Entity isn't in the component array.");
+
+    return mTicks[mEntities.index(entity)];
+  }
+
+  ComponentTicks &getTicksAt(size_t index) {
+    assert(index < mTicks.size() && "getTicksAt : Index out of range.");
+
+    return mTicks[index];
+  }
+
+  bool hasData(Entity entity) const { return mEntities.contains(entity); }
+
+  size_t size() const override { return mComponentArray.size(); }
+
+  size_t memoryUsage() const override {
+    return mComponentArray.memoryUsage() + mTicks.memoryUsage() + mEntities.memoryUsage();
+  }
+
+  const SparseSet &entities() const override { return mEntities; }
+
+  void swapSlots(size_t a, size_t b) override {
+    if (a == b) {
+      return;
+    }
+    std::swap(mComponentArray[a], mComponentArray[b]);
+    std::swap(mTicks[a], mTicks[b]);
+    mEntities.swap(a, b);
+  }
+
+  void entityDestroyed(Entity entity) override {
+    if (mEntities.contains(entity)) {
+      removeData(entity);
+    }
+  }
 
 private:
-  std::array<T, MAX_ENTITIES> mComponentArray{};
-  std::unordered_map<Entity, size_t> mEntityToIndex{};
-  std::unordered_map<size_t, Entity> mIndexToEntity{};
-  size_t currentSize{0};
+  PagedVector<T> mComponentArray{};
+  // same slots as mComponentArray
+  PagedVector<ComponentTicks> mTicks{};
+  SparseSet mEntities{};
 };
 
-} // namespace ecs
\ No newline at end of file
+} // namespace ecs
@@ -1,69 +1,142 @@
 #pragma once
 
 #include "../Type/ecs_type.hpp"
+#include "../Type/type_id.hpp"
 #include "component_array.hpp"
+#include "group.hpp"
 
+#include <array>
 #include <cassert>
-#include <iostream>
 #include <memory>
-#include <unordered_map>
+#include <vector>
 
 namespace ecs {
 class ComponentManager {
 
 public:
   template <typename T> void registerComponent() {
-    // Recovering type name as a string
-    const char *typeName = typeid(T).name();
-    assert(mComponentTypes.find(typeName) == mComponentTypes.end() &&
-           "registerComponent : Type already registered.");
-    mComponentTypes.insert({typeName, mNextComponentType});
-    // mComponentTypes[typeName] = mNextComponentType;
-    mComponentArrays.insert({typeName, std::make_shared<ComponentArray<T>>()});
-    // mComponentArrays[typeName] = std::make_shared<ComponentArray<T>>();
-    ++mNextComponentType;
+    const size_t type = componentTypeId<T>();
+    assert(type < MAX_COMPONENTS && "registerComponent : Too many component types.");
+    assert(!mComponentArrays[type] && "registerComponent : Type already registered.");
+
+    mComponentArrays[type] = std::make_unique<ComponentArray<T>>();
   }
 
-  template <typename T> ComponentType getComponentType() {
-    const char *typeName = typeid(T).name();
-    assert(mComponentTypes.find(typeName) != mComponentTypes.end() &&
+  template <typename T> ComponentType getComponentType() const {
+    const size_t type = componentTypeId<T>();
+    assert(type < MAX_COMPONENTS && mComponentArrays[type] &&
            "getComponentType : Type not registered.");
-    return mComponentTypes[typeName];
+    return static_cast<ComponentType>(type);
   }
 
-  template <typename T> void addComponent(Entity entity, T component) {
-    getComponentArray<T>()->insertData(entity, component);
+  template <typename T> void addComponent(Entity entity, T component, Tick tick) {
+    getComponentArray<T>()->insertData(entity, std::move(component), tick);
+    if (OwnedGroup *group = mOwners[getComponentType<T>()]) {
+      joinGroup(*group, entity);
+    }
   }
 
   template <typename T> void removeComponent(Entity entity) {
-    getComponentArray<T>()->removeData(entity);
+    removeComponent(entity, getComponentType<T>());
+  }
+
+  void removeComponent(Entity entity, ComponentType type) {
+    assert(mComponentArrays[type] && "removeComponent : Type not registered.");
+    if (OwnedGroup *group = mOwners[type]; group && group->contains(entity)) {
+      group->leave(entity);
+    }
+    mComponentArrays[type]->removeData(entity);
+  }
+
+  // Owned group of the Ts, created on first use with the entities already matching.
+  // Each array can only be owned by one group.
+  template <typename... Ts> OwnedGroup &getGroup() {
+    Signature owned;
+    (owned.set(getComponentType<Ts>()), ...);
+    for (const auto &group : mGroups) {
+      if (group->owned == owned) {
+        return *group;
+      }
+    }
+
+    auto group = std::make_unique<OwnedGroup>();
+    group->owned = owned;
+    group->arrays = {getComponentArray<Ts>()...};
+    for (ComponentType type : {getComponentType<Ts>()...}) {
+      assert(!mOwners[type] && "getGroup : Component already owned by another group.");
+      mOwners[type] = group.get();
+    }
+
+    // entering only swaps with slots already walked
+    const SparseSet &entities = group->arrays.front()->entities();
+    for (size_t i{0}; i < entities.size(); ++i) {
+      joinGroup(*group, entities.data()[i]);
+    }
+
+    mGroups.push_back(std::move(group));
+    return *mGroups.back();
+  }
+
+  size_t getGroupCount() const { return mGroups.size(); }
+
+  // For entities whose components were inserted straight into the arrays
+  void joinGroups(Entity entity) {
+    for (const auto &group : mGroups) {
+      joinGroup(*group, entity);
+    }
   }
 
   template <typename T> T &getComponent(Entity entity) {
     return getComponentArray<T>()->getData(entity);
   }
 
+  template <typename T> ComponentTicks &getTicks(Entity entity) {
+    return getComponentArray<T>()->getTicks(entity);
+  }
+
   void entityDestroyed(Entity entity) {
+    for (const auto &group : mGroups) {
+      if (group->contains(entity)) {
+        group->leave(entity);
+      }
+    }
+
     // For the current entity, delete in every component array tha data
     // attached to it
-    for (const auto &e : mComponentArrays) {
-      (e.second)->entityDestroyed(entity);
+    for (const auto &array : mComponentArrays) {
+      if (array) {
+        array->entityDestroyed(entity);
+      }
     }
   }
 
+  std::vector<PoolMemoryUsage> getMemoryUsage() const {
+    std::vector<PoolMemoryUsage> usage;
+    for (size_t type{0}; type < MAX_COMPONENTS; ++type) {
+      if (mComponentArrays[type]) {
+        usage.push_back({Signature{}.set(type), mComponentArrays[type]->size(),
+                         mComponentArrays[type]->memoryUsage()});
+      }
+    }
+    return usage;
+  }
+
+  template <typename T> ComponentArray<T> *getComponentArray() {
+    return static_cast<ComponentArray<T> *>(mComponentArrays[getComponentType<T>()].get());
+  }
+
 private:
-  // Component typename 1 - 1 to an "index" as ComponentType
-  std::unordered_map<const char *, ComponentType> mComponentTypes{};
-  // Component typename 1 - 1 to array of all this type of component
-  std::unordered_map<const char *, std::shared_ptr<IComponentArray>> mComponentArrays{};
-  ComponentType mNextComponentType{};
-
-  template <typename T> std::shared_ptr<ComponentArray<T>> getComponentArray() {
-    const char *typeName = typeid(T).name();
-    assert(mComponentTypes.find(typeName) != mComponentTypes.end() &&
-           "getComponentArray : Component Type not registerd.");
-    return std::static_pointer_cast<ComponentArray<T>>(mComponentArrays[typeName]);
+  static void joinGroup(OwnedGroup &group, Entity entity) {
+    if (!group.contains(entity) && group.matches(entity)) {
+      group.enter(entity);
+    }
   }
+
+  // ComponentType (see componentTypeId) 1 - 1 to array of all this type of component
+  std::array<std::unique_ptr<IComponentArray>, MAX_COMPONENTS> mComponentArrays{};
+  std::vector<std::unique_ptr<OwnedGroup>> mGroups{};
+  // group owning each array, if any
+  std::array<OwnedGroup *, MAX_COMPONENTS> mOwners{};
 };
 
-} // namespace ecs
\ No newline at end of file
+} // namespace ecs
@@ -1,61 +1,244 @@
 #pragma once
 
-#include <array>
+#include <atomic>
 #include <cassert>
-#include <queue>
+#include <vector>
 
 #include "../Type/ecs_type.hpp"
 
 namespace ecs {
 class EntityManager {
 public:
-  EntityManager() {
-    for (Entity entity{0}; entity < MAX_ENTITIES; ++entity) {
-      mAvailableEntities.push(entity);
-    }
-  }
-
   Entity createEntity() {
+    claimReserved();
     // check if we can add an entity
     assert(mLivingEntityCount < MAX_ENTITIES && "createEntity : Max entities count is reached.");
 
-    // Recover the entity and remove it from the availale queue
-    Entity curr = mAvailableEntities.front();
-    mAvailableEntities.pop();
     ++mLivingEntityCount;
 
-    return curr;
+    // Recycle the oldest destroyed slot first, otherwise grow by one slot
+    if (mFreeHead != INVALID_ENTITY) {
+      Entity index = mFreeHead;
+      setFreeHead(mSlots[index].nextFree);
+      if (mFreeHead == INVALID_ENTITY) {
+        mFreeTail = INVALID_ENTITY;
+      }
+      mSlots[index].nextFree = INVALID_ENTITY;
+      mSlots[index].living = true;
+      return makeEntity(index, mSlots[index].generation);
+    }
+
+    Entity index = static_cast<Entity>(mSlots.size());
+    mSlots.emplace_back().living = true;
+    return makeEntity(index, 0);
+  }
+
+  // Same as `count` createEntity calls, new slots are added in a single resize
+  void createEntities(Entity *entities, size_t count) {
+    claimReserved();
+    assert(mLivingEntityCount + count <= MAX_ENTITIES &&
+           "createEntities : Max entities count is reached.");
+
+    size_t i{0};
+    for (; i < count && mFreeHead != INVALID_ENTITY; ++i) {
+      entities[i] = createEntity();
+    }
+
+    const size_t fresh = count - i;
+    Entity index = static_cast<Entity>(mSlots.size());
+    mSlots.resize(mSlots.size() + fresh, Slot{{}, 0, INVALID_ENTITY, true});
+    for (; i < count; ++i) {
+      entities[i] = makeEntity(index++, 0);
+    }
+    mLivingEntityCount += static_cast<uint32_t>(fresh);
   }
 
   void destroyEntity(Entity entity) {
+    claimReserved();
     // check if the current entity exist
-    assert(entity < MAX_ENTITIES &&
-           "destroyEntity : Entity may be already destroyed or out of range.");
-
-    // set all its bit field to 0
-    mSignatures[entity].reset();
+    assert(isAlive(entity) && "destroyEntity : Entity may be already destroyed or out of range.");
 
-    // push our entity at the end of the queue
-    mAvailableEntities.push(entity);
+    freeSlot(entityIndex(entity));
     --mLivingEntityCount;
   }
 
+  // Handle of a future entity, safe to call from several threads at once as long as no
+  // other member runs meanwhile. The slot is taken from the free list without touching
+  // the slot table, the next call creating or destroying entities claims it for good
+  // (claimReserved). The entity isn't alive before createReserved, every reservation ends
+  // with createReserved or releaseReserved.
+  Entity reserveEntity() {
+    Entity index = mReserveHead.load(std::memory_order_relaxed);
+    // no slot is freed while reserving, a free slot's link can't change under us
+    while (index != INVALID_ENTITY &&
+           !mReserveHead.compare_exchange_weak(index, mSlots[index].nextFree,
+                                               std::memory_order_relaxed)) {
+    }
+    if (index != INVALID_ENTITY) {
+      return makeEntity(index, mSlots[index].generation);
+    }
+
+    const Entity fresh = mReservedFresh.fetch_add(1, std::memory_order_relaxed);
+    assert(mSlots.size() + fresh < MAX_ENTITIES &&
+           "reserveEntity : Max entities count is reached.");
+    return makeEntity(static_cast<Entity>(mSlots.size() + fresh), 0);
+  }
+
+  // Take the reserved slots out of the free list and add the fresh ones to the slot table.
+  // They stay dead until their own createReserved.
+  void claimReserved() {
+    const Entity head = mReserveHead.load(std::memory_order_relaxed);
+    for (Entity index = mFreeHead; index != head;) {
+      const Entity next = mSlots[index].nextFree;
+      mSlots[index].nextFree = INVALID_ENTITY;
+      ++mReservedCount;
+      index = next;
+    }
+    mFreeHead = head;
+    if (mFreeHead == INVALID_ENTITY) {
+      mFreeTail = INVALID_ENTITY;
+    }
+
+    const Entity fresh = mReservedFresh.exchange(0, std::memory_order_relaxed);
+    mSlots.resize(mSlots.size() + fresh);
+    mReservedCount += fresh;
+  }
+
+  // The reserved entity becomes alive, without signature
+  void createReserved(Entity entity) {
+    claimReserved();
+    assert(isReserved(entity) && "createReserved : Entity is not reserved.");
+    mSlots[entityIndex(entity)].living = true;
+    --mReservedCount;
+    ++mLivingEntityCount;
+  }
+
+  // The reservation is dropped, the slot goes back to the free list like a destroyed one
+  void releaseReserved(Entity entity) {
+    claimReserved();
+    assert(isReserved(entity) && "releaseReserved : Entity is not reserved.");
+    freeSlot(entityIndex(entity));
+    --mReservedCount;
+  }
+
+  bool isAlive(Entity entity) const {
+    const Entity index = entityIndex(entity);
+    // a freed slot already got its generation bumped, no handle carries it yet
+    return index < mSlots.size() && mSlots[index].living &&
+           mSlots[index].generation == entityGeneration(entity);
+  }
+
   void setSignature(Entity entity, Signature signature) {
-    // check if the entity is in range
-    assert(entity < MAX_ENTITIES && "SetSignatue : Entity may be out of range.");
+    // check if the entity is alive
+    assert(isAlive(entity) && "SetSignatue : Entity may be out of range.");
 
     // assign signature to the entity
-    mSignatures[entity] = signature;
+    mSlots[entityIndex(entity)].signature = signature;
+  }
+
+  Signature getSignature(Entity entity) const {
+    assert(isAlive(entity) && "GetSignatue : Entity may be out of range.");
+    return mSlots[entityIndex(entity)].signature;
   }
 
-  Signature getSignature(Entity entity) {
-    assert(entity < MAX_ENTITIES && "GetSignatue : Entity may be out of range.");
-    return mSignatures[entity];
+  uint32_t getLivingEntityCount() const { return mLivingEntityCount; }
+
+  size_t getSlotCount() const { return mSlots.size(); }
+  Entity getGeneration(Entity index) const { return mSlots[index].generation; }
+
+  // Handle of every living entity, in slot order
+  std::vector<Entity> getLivingEntities() const {
+    std::vector<Entity> living;
+    living.reserve(mLivingEntityCount);
+    for (Entity index{0}; index < mSlots.size(); ++index) {
+      if (mSlots[index].living) {
+        living.push_back(makeEntity(index, mSlots[index].generation));
+      }
+    }
+    return living;
+  }
+
+  // Replace the empty slot table by a saved one. Living entities start without signature,
+  // every other slot goes to the free list in slot order.
+  void restore(const Entity *generations, size_t slotCount, const Entity *living,
+               size_t livingCount) {
+    claimReserved();
+    assert(mLivingEntityCount == 0 && "restore : Entities are still alive.");
+    assert(mReservedCount == 0 && "restore : Entities are still reserved.");
+
+    mSlots.assign(slotCount, Slot{});
+    std::vector<bool> alive(slotCount, false);
+    for (size_t i{0}; i < livingCount; ++i) {
+      assert(entityIndex(living[i]) < slotCount && "restore : Living entity out of range.");
+      alive[entityIndex(living[i])] = true;
+    }
+
+    setFreeHead(INVALID_ENTITY);
+    mFreeTail = INVALID_ENTITY;
+    for (Entity index{0}; index < slotCount; ++index) {
+      mSlots[index].generation = generations[index] & ENTITY_GENERATION_MASK;
+      if (alive[index]) {
+        mSlots[index].living = true;
+        continue;
+      }
+      if (mFreeTail != INVALID_ENTITY) {
+        mSlots[mFreeTail].nextFree = index;
+      } else {
+        setFreeHead(index);
+      }
+      mFreeTail = index;
+    }
+    mLivingEntityCount = static_cast<uint32_t>(livingCount);
   }
 
 private:
-  std::queue<Entity> mAvailableEntities{};
-  std::array<Signature, MAX_ENTITIES> mSignatures{};
+  bool isReserved(Entity entity) const {
+    const Entity index = entityIndex(entity);
+    return index < mSlots.size() && !mSlots[index].living &&
+           mSlots[index].nextFree == INVALID_ENTITY && index != mFreeTail &&
+           mSlots[index].generation == entityGeneration(entity);
+  }
+
+  // Invalidate every handle on the slot and push it at the end of the free list,
+  // FIFO spreads generation wrap-around
+  void freeSlot(Entity index) {
+    Slot &slot = mSlots[index];
+    slot.signature.reset();
+    slot.generation = (slot.generation + 1) & ENTITY_GENERATION_MASK;
+    slot.living = false;
+
+    if (mFreeTail != INVALID_ENTITY) {
+      mSlots[mFreeTail].nextFree = index;
+    } else {
+      setFreeHead(index);
+    }
+    mFreeTail = index;
+  }
+
+  // Outside of reservations both heads are the same
+  void setFreeHead(Entity index) {
+    mFreeHead = index;
+    mReserveHead.store(index, std::memory_order_relaxed);
+  }
+
+  // One per entity slot ever used, grows with the world
+  struct Slot {
+    Signature signature{};
+    Entity generation{0};
+    // Intrusive free list link, INVALID_ENTITY while the slot is in use or reserved
+    Entity nextFree{INVALID_ENTITY};
+    bool living{false};
+  };
+
+  std::vector<Slot> mSlots{};
+  Entity mFreeHead{INVALID_ENTITY};
+  Entity mFreeTail{INVALID_ENTITY};
+  // first free slot not reserved yet, slots from mFreeHead up to it are reserved
+  std::atomic<Entity> mReserveHead{INVALID_ENTITY};
+  // reserved slots past the end of mSlots
+  std::atomic<Entity> mReservedFresh{0};
   uint32_t mLivingEntityCount{};
+  // claimed reservations not created or released yet
+  uint32_t mReservedCount{};
 };
-} // namespace ecs
\ No newline at end of file
+} // namespace ecs
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+namespace ecs {
+
+// Turns variable frame times into a whole number of fixed simulation steps.
+// The time left over is carried to the next frame, alpha() tells how far the rendered
+// frame is between the last two simulated states. A frame never runs more than
+// maxSteps steps: the time beyond is dropped so a slow frame doesn't make the next one
+// slower too.
+class FixedTimestep {
+public:
+  // The step is the float handed to the simulation, a frame time of exactly step() then
+  // always makes exactly one step
+  FixedTimestep(float tickRate, uint32_t maxSteps)
+      : mStep{static_cast<float>(1.0 / tickRate)}, mMaxSteps{maxSteps} {
+    assert(tickRate > 0.f && maxSteps > 0 && "FixedTimestep : Invalid tick rate or step cap.");
+  }
+
+  // Add the frame time, return the number of steps to simulate
+  uint32_t advance(float frameTime) {
+    mAccumulator += frameTime;
+    const uint32_t steps =
+        static_cast<uint32_t>(std::min(mAccumulator / mStep, static_cast<double>(mMaxSteps)));
+    mAccumulator -= steps * mStep;
+    if (steps == mMaxSteps) {
+      mAccumulator = std::fmod(mAccumulator, mStep);
+    }
+    return steps;
+  }
+
+  float step() const { return static_cast<float>(mStep); }
+
+  // In [0, 1], 0 is the previous state and 1 the current one
+  float alpha() const { return static_cast<float>(std::min(mAccumulator / mStep, 1.0)); }
+
+private:
+  // seconds, double so the remainder doesn't drift over a long run, mStep holds a float
+  double mStep;
+  uint32_t mMaxSteps;
+  double mAccumulator{0.0};
+};
+
+} // namespace ecs
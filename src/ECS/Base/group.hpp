@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../Type/ecs_type.hpp"
+#include "component_array.hpp"
+#include "view.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+namespace ecs {
+
+// Entities owning every `owned` component, kept in the slots [0, size) of each owned array,
+// in the same order. Maintained by the ComponentManager, an array has at most one owner.
+struct OwnedGroup {
+  Signature owned{};
+  std::vector<IComponentArray *> arrays{};
+  size_t size{0};
+
+  bool contains(Entity entity) const {
+    const SparseSet &entities = arrays.front()->entities();
+    return entities.contains(entity) && entities.index(entity) < size;
+  }
+
+  bool matches(Entity entity) const {
+    return std::all_of(arrays.begin(), arrays.end(), [entity](const IComponentArray *array) {
+      return array->entities().contains(entity);
+    });
+  }
+
+  // Swap the entity to the end of the group in every array
+  void enter(Entity entity) {
+    for (IComponentArray *array : arrays) {
+      array->swapSlots(array->entities().index(entity), size);
+    }
+    ++size;
+  }
+
+  // Swap the entity right after the group in every array
+  void leave(Entity entity) {
+    --size;
+    for (IComponentArray *array : arrays) {
+      array->swapSlots(array->entities().index(entity), size);
+    }
+  }
+};
+
+// Iteration over an owned group: the component arrays are walked side by side on
+// [0, size), without any lookup. With the archetype backend, where chunks are packed
+// per signature already, a group is a plain View.
+// Adding or removing the grouped components while iterating is not allowed.
+template <typename... Ts> class Group {
+public:
+  Group(const OwnedGroup &group, ComponentArray<Ts> *...arrays)
+      : mGroup{&group}, mArrays{arrays...} {}
+
+  explicit Group(View<Ts...> view) : mView{std::move(view)} {}
+
+  // fn(Entity, Ts &...)
+  template <typename F> void each(F &&fn) const { eachInRange(0, sizeHint(), fn); }
+
+  // Same as each() restricted to the slots [first, last) of [0, sizeHint())
+  template <typename F> void eachInRange(size_t first, size_t last, F &&fn) const {
+    if (mView) {
+      mView->eachInRange(first, last, fn);
+      return;
+    }
+
+    const Entity *entities = mGroup->arrays.front()->entities().data();
+    last = std::min(last, mGroup->size);
+    for (size_t i{first}; i < last; ++i) {
+      fn(entities[i], std::get<ComponentArray<Ts> *>(mArrays)->getDataAt(i)...);
+    }
+  }
+
+  // Exact with the sparse set backend, upper bound with the archetype one
+  size_t sizeHint() const { return mView ? mView->sizeHint() : mGroup->size; }
+
+private:
+  const OwnedGroup *mGroup{nullptr};
+  std::tuple<ComponentArray<Ts> *...> mArrays{};
+  std::optional<View<Ts...>> mView{};
+};
+
+} // namespace ecs
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "../../profiler/profiler.hpp"
+#include "group.hpp"
+#include "view.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ecs {
+
+// Number of jobs submitted against it and not finished yet
+struct JobCounter {
+  std::atomic<size_t> pending{0};
+};
+
+// Worker pool with one deque per thread and work stealing.
+// A thread pushes and pops its own jobs at the back (the last job submitted is
+// the hottest in cache), idle threads steal the oldest ones at the front of the
+// others. Threads outside of the pool share an extra deque.
+// wait() runs jobs instead of blocking, so jobs may submit and wait for jobs.
+class JobSystem {
+public:
+  using Job = std::function<void()>;
+
+  explicit JobSystem(size_t workerCount = std::max(std::thread::hardware_concurrency(), 1u) - 1) {
+    // queue 0 is shared by the threads outside of the pool
+    for (size_t i{0}; i <= workerCount; ++i) {
+      mQueues.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i{1}; i <= workerCount; ++i) {
+      mWorkers.emplace_back([this, i] { workerLoop(i); });
+    }
+  }
+
+  ~JobSystem() {
+    {
+      std::lock_guard<std::mutex> lock{mSleepMutex};
+      mStop = true;
+    }
+    mSleepCondition.notify_all();
+    for (std::thread &worker : mWorkers) {
+      worker.join();
+    }
+  }
+
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+  void submit(JobCounter &counter, Job job) {
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+
+    Queue &queue = *mQueues[queueIndex()];
+    {
+      std::lock_guard<std::mutex> lock{queue.mutex};
+      queue.jobs.push_back(Entry{std::move(job), &counter});
+    }
+    mSubmitted.fetch_add(1, std::memory_order_release);
+    // a worker about to sleep holds the mutex while checking mSubmitted, it can't miss this
+    // wake-up
+    { std::lock_guard<std::mutex> lock{mSleepMutex}; }
+    mSleepCondition.notify_one();
+  }
+
+  // Run jobs until every job of the counter is done
+  void wait(JobCounter &counter) {
+    const size_t self = queueIndex();
+    while (counter.pending.load(std::memory_order_acquire) > 0) {
+      if (!runOne(self)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  // fn(begin, end) on chunks of at most `chunkSize` indices covering [0, count)
+  template <typename F> void parallelFor(size_t count, size_t chunkSize, F &&fn) {
+    chunkSize = std::max<size_t>(chunkSize, 1);
+    if (count <= chunkSize || mWorkers.empty()) {
+      if (count > 0) {
+        fn(size_t{0}, count);
+      }
+      return;
+    }
+
+    JobCounter counter;
+    // the calling thread keeps the first chunk
+    for (size_t begin{chunkSize}; begin < count; begin += chunkSize) {
+      const size_t end = std::min(begin + chunkSize, count);
+      submit(counter, [&fn, begin, end] { fn(begin, end); });
+    }
+    fn(size_t{0}, chunkSize);
+    wait(counter);
+  }
+
+  // fn(Entity, Ts &...) for every entity of the view, split in chunks of `chunkSize` entities.
+  // Each entity is visited by exactly one thread: writing its own components is safe.
+  template <typename... Ts, typename F>
+  void parallelFor(View<Ts...> view, size_t chunkSize, F &&fn) {
+    parallelFor(view.sizeHint(), chunkSize,
+                [&view, &fn](size_t begin, size_t end) { view.eachInRange(begin, end, fn); });
+  }
+
+  // Same for a group
+  template <typename... Ts, typename F>
+  void parallelFor(Group<Ts...> group, size_t chunkSize, F &&fn) {
+    parallelFor(group.sizeHint(), chunkSize,
+                [&group, &fn](size_t begin, size_t end) { group.eachInRange(begin, end, fn); });
+  }
+
+  size_t getWorkerCount() const { return mWorkers.size(); }
+  // Workers plus the calling thread
+  size_t getThreadCount() const { return mWorkers.size() + 1; }
+
+private:
+  struct Entry {
+    Job job;
+    JobCounter *counter{nullptr};
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Entry> jobs;
+  };
+
+  // Identify the pool the current thread works for, a thread may only work for one
+  struct ThreadSlot {
+    const JobSystem *owner{nullptr};
+    size_t index{0};
+  };
+
+  static ThreadSlot &threadSlot() {
+    thread_local ThreadSlot slot{};
+    return slot;
+  }
+
+  size_t queueIndex() const {
+    const ThreadSlot &slot = threadSlot();
+    return slot.owner == this ? slot.index : 0;
+  }
+
+  void workerLoop(size_t index) {
+    threadSlot() = ThreadSlot{this, index};
+    PROFILE_THREAD("Worker " + std::to_string(index));
+
+    while (true) {
+      // every job submitted up to here is seen by the pass below
+      const size_t submitted = mSubmitted.load(std::memory_order_acquire);
+      if (runOne(index)) {
+        continue;
+      }
+      // the jobs left are being run by other threads, only a new submit brings work
+      std::unique_lock<std::mutex> lock{mSleepMutex};
+      mSleepCondition.wait(lock, [this, submitted] {
+        return mSubmitted.load(std::memory_order_relaxed) != submitted || mStop;
+      });
+      if (mStop) {
+        return;
+      }
+    }
+  }
+
+  // Pop from our own deque, steal otherwise. Returns false when every deque is empty.
+  bool runOne(size_t self) {
+    Entry entry{};
+    if (!pop(self, entry)) {
+      bool stolen = false;
+      for (size_t offset{1}; offset < mQueues.size() && !stolen; ++offset) {
+        stolen = steal((self + offset) % mQueues.size(), entry);
+      }
+      if (!stolen) {
+        return false;
+      }
+    }
+    {
+      PROFILE_ZONE("Job");
+      entry.job();
+    }
+    entry.counter->pending.fetch_sub(1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(size_t index, Entry &entry) {
+    Queue &queue = *mQueues[index];
+    std::lock_guard<std::mutex> lock{queue.mutex};
+    if (queue.jobs.empty()) {
+      return false;
+    }
+    entry = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+  }
+
+  bool steal(size_t index, Entry &entry) {
+    Queue &queue = *mQueues[index];
+    std::lock_guard<std::mutex> lock{queue.mutex};
+    if (queue.jobs.empty()) {
+      return false;
+    }
+    entry = std::move(queue.jobs.front());
+    queue.jobs.pop_front();
+    return true;
+  }
+
+  std::vector<std::unique_ptr<Queue>> mQueues{};
+  std::vector<std::thread> mWorkers{};
+
+  // idle workers sleep until something is submitted
+  std::mutex mSleepMutex;
+  std::condition_variable mSleepCondition;
+  std::atomic<size_t> mSubmitted{0};
+  bool mStop{false};
+};
+
+} // namespace ecs
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../Type/ecs_type.hpp"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ecs {
+
+enum class ComponentEvent { Add, Remove, Update };
+
+// fn(entities) with every entity touched by the event since the previous dispatch
+using Observer = std::function<void(const std::vector<Entity> &)>;
+
+// Component events collected during the frame and handed to the observers in batches.
+// Only events somebody observes are recorded. Connect the observers before the systems
+// run, recording may then happen from several threads.
+class Observers {
+public:
+  void connect(ComponentType type, ComponentEvent event, Observer observer) {
+    mSlots[slotIndex(type, event)].observers.push_back(std::move(observer));
+  }
+
+  bool observed(ComponentType type, ComponentEvent event) const {
+    return !mSlots[slotIndex(type, event)].observers.empty();
+  }
+
+  void record(ComponentType type, ComponentEvent event, const Entity *entities, size_t count) {
+    Slot &slot = mSlots[slotIndex(type, event)];
+    if (slot.observers.empty()) {
+      return;
+    }
+    std::lock_guard lock{mMutex};
+    slot.pending.insert(slot.pending.end(), entities, entities + count);
+  }
+
+  void record(ComponentType type, ComponentEvent event, Entity entity) {
+    record(type, event, &entity, 1);
+  }
+
+  // Every event of every component of the signature
+  void record(Signature signature, ComponentEvent event, Entity entity) {
+    for (size_t type{0}; type < MAX_COMPONENTS; ++type) {
+      if (signature.test(type)) {
+        record(static_cast<ComponentType>(type), event, entity);
+      }
+    }
+  }
+
+  // Per component type, removals then additions then updates. Each batch is sorted without
+  // duplicates, `keep(type, entity)` filters additions and updates on entities that no longer
+  // own the component. Events recorded by the observers themselves go to the next dispatch.
+  template <typename Keep> void dispatch(Keep &&keep) {
+    for (size_t type{0}; type < MAX_COMPONENTS; ++type) {
+      for (ComponentEvent event :
+           {ComponentEvent::Remove, ComponentEvent::Add, ComponentEvent::Update}) {
+        Slot &slot = mSlots[slotIndex(static_cast<ComponentType>(type), event)];
+        if (slot.observers.empty()) {
+          continue;
+        }
+
+        std::vector<Entity> batch;
+        {
+          std::lock_guard lock{mMutex};
+          batch.swap(slot.pending);
+        }
+        std::sort(batch.begin(), batch.end());
+        batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+        if (event != ComponentEvent::Remove) {
+          std::erase_if(batch, [&](Entity entity) {
+            return !keep(static_cast<ComponentType>(type), entity);
+          });
+        }
+        if (batch.empty()) {
+          continue;
+        }
+
+        for (const Observer &observer : slot.observers) {
+          observer(batch);
+        }
+      }
+    }
+  }
+
+private:
+  struct Slot {
+    std::vector<Observer> observers{};
+    std::vector<Entity> pending{};
+  };
+
+  static size_t slotIndex(ComponentType type, ComponentEvent event) {
+    return type * 3 + static_cast<size_t>(event);
+  }
+
+  std::array<Slot, MAX_COMPONENTS * 3> mSlots{};
+  std::mutex mMutex;
+};
+
+} // namespace ecs
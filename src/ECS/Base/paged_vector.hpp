@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ecs {
+
+// Packed array split in fixed-size pages allocated on demand.
+// Growing never moves the elements, so their addresses stay stable, and an
+// empty array costs no page at all.
+template <typename T> class PagedVector {
+public:
+  static constexpr size_t PAGE_BYTES = 16 * 1024;
+  // power of two so indexing is a shift and a mask
+  static constexpr size_t PAGE_SIZE = std::bit_floor(std::max<size_t>(PAGE_BYTES / sizeof(T), 1));
+
+  PagedVector() = default;
+  ~PagedVector() {
+    while (mSize > 0) {
+      pop_back();
+    }
+    for (T *page : mPages) {
+      freePage(page);
+    }
+  }
+
+  PagedVector(const PagedVector &) = delete;
+  PagedVector &operator=(const PagedVector &) = delete;
+
+  T &operator[](size_t index) {
+    assert(index < mSize && "PagedVector : Index out of range.");
+    return mPages[index / PAGE_SIZE][index % PAGE_SIZE];
+  }
+
+  const T &operator[](size_t index) const {
+    assert(index < mSize && "PagedVector : Index out of range.");
+    return mPages[index / PAGE_SIZE][index % PAGE_SIZE];
+  }
+
+  T &back() { return (*this)[mSize - 1]; }
+
+  void push_back(T value) {
+    if (mSize == mPages.size() * PAGE_SIZE) {
+      mPages.push_back(allocatePage());
+    }
+    new (&mPages[mSize / PAGE_SIZE][mSize % PAGE_SIZE]) T(std::move(value));
+    ++mSize;
+  }
+
+  // Allocate the pages needed to hold `count` elements without further allocation
+  void reserve(size_t count) {
+    while (mPages.size() * PAGE_SIZE < count) {
+      mPages.push_back(allocatePage());
+    }
+  }
+
+  // Append `count` elements copied from raw bytes, one memcpy per page.
+  // `bytes` doesn't need to be aligned for T.
+  void append(const std::byte *bytes, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>, "append : T must be trivially copyable.");
+    reserve(mSize + count);
+    while (count > 0) {
+      const size_t run = std::min(count, PAGE_SIZE - mSize % PAGE_SIZE);
+      std::memcpy(&mPages[mSize / PAGE_SIZE][mSize % PAGE_SIZE], bytes, run * sizeof(T));
+      bytes += run * sizeof(T);
+      mSize += run;
+      count -= run;
+    }
+  }
+
+  // Append `count` elements moved out of `values`, one run per page
+  void appendMoved(T *values, size_t count) {
+    reserve(mSize + count);
+    while (count > 0) {
+      const size_t run = std::min(count, PAGE_SIZE - mSize % PAGE_SIZE);
+      std::uninitialized_move_n(values, run, &mPages[mSize / PAGE_SIZE][mSize % PAGE_SIZE]);
+      values += run;
+      mSize += run;
+      count -= run;
+    }
+  }
+
+  // Append `count` copies of the value
+  void append(size_t count, const T &value) {
+    static_assert(std::is_trivially_copyable_v<T>, "append : T must be trivially copyable.");
+    reserve(mSize + count);
+    while (count > 0) {
+      const size_t run = std::min(count, PAGE_SIZE - mSize % PAGE_SIZE);
+      std::fill_n(&mPages[mSize / PAGE_SIZE][mSize % PAGE_SIZE], run, value);
+      mSize += run;
+      count -= run;
+    }
+  }
+
+  void pop_back() {
+    assert(mSize > 0 && "PagedVector : pop_back on an empty array.");
+    back().~T();
+    --mSize;
+
+    // keep one spare page so an array bouncing on a page edge doesn't reallocate
+    if (mPages.size() >= 2 && mSize + 2 * PAGE_SIZE <= mPages.size() * PAGE_SIZE) {
+      freePage(mPages.back());
+      mPages.pop_back();
+    }
+  }
+
+  size_t size() const { return mSize; }
+  bool empty() const { return mSize == 0; }
+
+  // Bytes currently allocated, pages and page table
+  size_t memoryUsage() const {
+    return mPages.size() * PAGE_SIZE * sizeof(T) + mPages.capacity() * sizeof(T *);
+  }
+
+private:
+  static T *allocatePage() {
+    return static_cast<T *>(::operator new(PAGE_SIZE * sizeof(T), std::align_val_t{alignof(T)}));
+  }
+
+  static void freePage(T *page) { ::operator delete(page, std::align_val_t{alignof(T)}); }
+
+  std::vector<T *> mPages{};
+  size_t mSize{0};
+};
+
+} // namespace ecs
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <tuple>
+#include <utility>
+
+namespace ecs {
+
+// Component values copied into every entity spawned from it, see Centralizer::createEntities
+template <typename... Ts> struct Prefab {
+  std::tuple<Ts...> components;
+};
+
+template <typename... Ts> Prefab<Ts...> makePrefab(Ts... components) {
+  return Prefab<Ts...>{std::tuple<Ts...>{std::move(components)...}};
+}
+
+} // namespace ecs
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../Type/ecs_type.hpp"
+#include "job_system.hpp"
+#include "system.hpp"
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace ecs {
+
+// Runs the tasks added during a frame on a JobSystem.
+// Every task carries the reads / writes of its system. Two tasks conflict when
+// one writes a component the other reads or writes: they run one after the
+// other in the order they were added. Everything else may run at the same time.
+// The thread calling run() works too and returns once every task is done.
+class Scheduler {
+public:
+  explicit Scheduler(JobSystem &jobSystem) : mJobSystem{jobSystem} {}
+
+  Scheduler(const Scheduler &) = delete;
+  Scheduler &operator=(const Scheduler &) = delete;
+
+  void add(const System &system, std::function<void()> task) {
+    add(system.mReads, system.mWrites, std::move(task));
+  }
+
+  void add(Signature reads, Signature writes, std::function<void()> task) {
+    mTasks.push_back(Task{reads, writes, std::move(task)});
+  }
+
+  // Build the dependency graph of the added tasks, run them and forget them
+  void run() {
+    PROFILE_ZONE("Scheduler::run");
+    std::vector<size_t> roots;
+    for (size_t j{0}; j < mTasks.size(); ++j) {
+      for (size_t i{0}; i < j; ++i) {
+        if (conflicts(mTasks[i], mTasks[j])) {
+          mTasks[i].dependents.push_back(j);
+          ++mTasks[j].pending;
+        }
+      }
+      if (mTasks[j].pending == 0) {
+        roots.push_back(j);
+      }
+    }
+
+    // pending counts are only touched by the running tasks from here
+    JobCounter counter;
+    for (size_t root : roots) {
+      submit(counter, root);
+    }
+    mJobSystem.wait(counter);
+
+    mTasks.clear();
+  }
+
+private:
+  struct Task {
+    Signature reads;
+    Signature writes;
+    std::function<void()> fn;
+    std::vector<size_t> dependents{};
+    size_t pending{0};
+  };
+
+  static bool conflicts(const Task &a, const Task &b) {
+    return (a.writes & (b.reads | b.writes)).any() || (b.writes & a.reads).any();
+  }
+
+  // Run the task then release its dependents. They are submitted before the task counts
+  // as done so the counter can't reach zero in between.
+  void submit(JobCounter &counter, size_t index) {
+    mJobSystem.submit(counter, [this, &counter, index] {
+      mTasks[index].fn();
+      for (size_t dependent : mTasks[index].dependents) {
+        std::atomic_ref<size_t> pending{mTasks[dependent].pending};
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          submit(counter, dependent);
+        }
+      }
+    });
+  }
+
+  JobSystem &mJobSystem;
+  std::vector<Task> mTasks{};
+};
+
+} // namespace ecs
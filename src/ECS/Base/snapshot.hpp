@@ -0,0 +1,343 @@
+#pragma once
+
+#include "../Type/ecs_type.hpp"
+#include "centralizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MACHINA_SNAPSHOT_MMAP 1
+#endif
+
+namespace ecs {
+
+// Binary image of a world, written and read in one go.
+// Layout, in the byte order of the machine that wrote it, every block 64 bytes aligned:
+//   Header
+//   Section[sectionCount]
+//   Entity generations[slotCount], Entity living[livingCount]
+//   per section: Entity entities[count], then the packed components, count * size bytes
+// A section is found back by the name its component was registered with, sections without
+// a registered component are skipped. Signatures aren't stored, they follow from the
+// sections, so a snapshot doesn't depend on the component type ids of the process.
+// Only trivially copyable components can be registered, the others are left out.
+class Snapshot {
+public:
+  static constexpr std::uint32_t VERSION = 1;
+  static constexpr size_t NAME_SIZE = 32;
+
+  explicit Snapshot(Centralizer &centralizer) : mCentralizer{centralizer} {}
+
+  // Registration hook: the name identifies the component in the file, keep it stable
+  template <typename T> void registerComponent(const char *name) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "registerComponent : Snapshot components must be trivially copyable.");
+    assert(std::strlen(name) < NAME_SIZE && "registerComponent : Name too long.");
+
+    Entry entry{};
+    std::strncpy(entry.name.data(), name, NAME_SIZE - 1);
+    entry.type = mCentralizer.getComponentType<T>();
+    entry.size = sizeof(T);
+    entry.collect = [](Centralizer &centralizer, std::vector<Entity> &entities,
+                       std::vector<std::byte> &values) {
+      auto view = centralizer.view<T>();
+      entities.reserve(view.sizeHint());
+      values.reserve(view.sizeHint() * sizeof(T));
+      view.each([&](Entity e, T &component) {
+        entities.push_back(e);
+        const auto *bytes = reinterpret_cast<const std::byte *>(&component);
+        values.insert(values.end(), bytes, bytes + sizeof(T));
+      });
+    };
+    entry.restore = [](Centralizer &centralizer, const Entity *entities, const std::byte *values,
+                       size_t count) {
+      centralizer.restoreComponents<T>(entities, values, count);
+    };
+    mEntries.push_back(entry);
+  }
+
+  // False when the file can't be written
+  bool save(const std::string &path) const {
+    std::vector<Entity> living = mCentralizer.mEntityManager->getLivingEntities();
+    const size_t slotCount = mCentralizer.mEntityManager->getSlotCount();
+
+    std::vector<std::vector<Entity>> entities(mEntries.size());
+    std::vector<std::vector<std::byte>> values(mEntries.size());
+    for (size_t i{0}; i < mEntries.size(); ++i) {
+      mEntries[i].collect(mCentralizer, entities[i], values[i]);
+    }
+
+    std::vector<Section> sections(mEntries.size());
+    size_t offset = alignUp(sizeof(Header) + sections.size() * sizeof(Section));
+    const size_t slotsOffset = offset;
+    offset = alignUp(offset + (slotCount + living.size()) * sizeof(Entity));
+    for (size_t i{0}; i < mEntries.size(); ++i) {
+      std::memcpy(sections[i].name, mEntries[i].name.data(), NAME_SIZE);
+      sections[i].size = mEntries[i].size;
+      sections[i].count = entities[i].size();
+      sections[i].offset = offset;
+      offset = alignUp(offset + entities[i].size() * sizeof(Entity) + values[i].size());
+    }
+
+    std::vector<std::byte> file(offset);
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.sectionCount = static_cast<std::uint32_t>(sections.size());
+    header.slotCount = slotCount;
+    header.livingCount = living.size();
+    header.slotsOffset = slotsOffset;
+    std::memcpy(file.data(), &header, sizeof(Header));
+    std::memcpy(file.data() + sizeof(Header), sections.data(), sections.size() * sizeof(Section));
+
+    auto *generations = reinterpret_cast<Entity *>(file.data() + slotsOffset);
+    for (Entity index{0}; index < slotCount; ++index) {
+      generations[index] = mCentralizer.mEntityManager->getGeneration(index);
+    }
+    std::memcpy(generations + slotCount, living.data(), living.size() * sizeof(Entity));
+
+    for (size_t i{0}; i < sections.size(); ++i) {
+      std::byte *section = file.data() + sections[i].offset;
+      std::memcpy(section, entities[i].data(), entities[i].size() * sizeof(Entity));
+      std::memcpy(section + entities[i].size() * sizeof(Entity), values[i].data(),
+                  values[i].size());
+    }
+
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(reinterpret_cast<const char *>(file.data()), static_cast<std::streamsize>(offset));
+    return static_cast<bool>(out);
+  }
+
+  // Load into a world without living entity, with the components of the file registered.
+  // The file is mapped in memory and each section bulk-copied into the storage, components
+  // are stamped with the current tick. False when the file can't be read or isn't a valid
+  // snapshot of this version, the world is untouched then.
+  bool load(const std::string &path) {
+    assert(mCentralizer.mEntityManager->getLivingEntityCount() == 0 &&
+           "load : The world must be empty.");
+
+    FileView file{path};
+    if (!file.data || !validate(file)) {
+      return false;
+    }
+
+    Header header;
+    std::memcpy(&header, file.data, sizeof(Header));
+    std::vector<Section> sections(header.sectionCount);
+    std::memcpy(sections.data(), file.data + sizeof(Header), sections.size() * sizeof(Section));
+
+    std::vector<Entity> slots(header.slotCount + header.livingCount);
+    std::memcpy(slots.data(), file.data + header.slotsOffset, slots.size() * sizeof(Entity));
+    const Entity *generations = slots.data();
+    const Entity *living = slots.data() + header.slotCount;
+
+    // signature of each living entity, from the sections it appears in
+    std::vector<size_t> livingIndex(header.slotCount, 0);
+    for (size_t i{0}; i < header.livingCount; ++i) {
+      livingIndex[entityIndex(living[i])] = i;
+    }
+    std::vector<Signature> signatures(header.livingCount);
+    std::vector<const Entry *> matched(sections.size(), nullptr);
+    std::vector<Entity> sectionEntities;
+    for (size_t s{0}; s < sections.size(); ++s) {
+      matched[s] = findEntry(sections[s]);
+      if (!matched[s]) {
+        continue;
+      }
+      sectionEntities.resize(sections[s].count);
+      std::memcpy(sectionEntities.data(), file.data + sections[s].offset,
+                  sectionEntities.size() * sizeof(Entity));
+      for (Entity e : sectionEntities) {
+        signatures[livingIndex[entityIndex(e)]].set(matched[s]->type);
+      }
+    }
+
+    mCentralizer.restoreEntities(generations, header.slotCount, living, signatures.data(),
+                                 header.livingCount);
+    for (size_t s{0}; s < sections.size(); ++s) {
+      if (!matched[s]) {
+        continue;
+      }
+      sectionEntities.resize(sections[s].count);
+      const std::byte *section = file.data + sections[s].offset;
+      std::memcpy(sectionEntities.data(), section, sectionEntities.size() * sizeof(Entity));
+      matched[s]->restore(mCentralizer, sectionEntities.data(),
+                          section + sectionEntities.size() * sizeof(Entity), sections[s].count);
+    }
+    mCentralizer.publishRestored(living, header.livingCount);
+
+    return true;
+  }
+
+private:
+  static constexpr char MAGIC[8] = {'M', 'C', 'H', 'S', 'N', 'A', 'P', '\0'};
+  static constexpr size_t BLOCK_ALIGN = 64;
+
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t sectionCount;
+    std::uint64_t slotCount;
+    std::uint64_t livingCount;
+    std::uint64_t slotsOffset;
+  };
+
+  struct Section {
+    char name[NAME_SIZE];
+    std::uint64_t size;
+    std::uint64_t count;
+    std::uint64_t offset;
+  };
+
+  struct Entry {
+    std::array<char, NAME_SIZE> name{};
+    ComponentType type{0};
+    size_t size{0};
+    void (*collect)(Centralizer &, std::vector<Entity> &, std::vector<std::byte> &){nullptr};
+    void (*restore)(Centralizer &, const Entity *, const std::byte *, size_t){nullptr};
+  };
+
+  // Read-only bytes of a whole file, mapped when the platform allows it
+  struct FileView {
+    explicit FileView(const std::string &path) {
+#ifdef MACHINA_SNAPSHOT_MMAP
+      const int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0) {
+        return;
+      }
+      struct stat info {};
+      if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+        void *mapped = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+          data = static_cast<const std::byte *>(mapped);
+          size = static_cast<size_t>(info.st_size);
+        }
+      }
+      ::close(fd);
+#else
+      std::ifstream in{path, std::ios::binary | std::ios::ate};
+      if (!in) {
+        return;
+      }
+      buffer.resize(static_cast<size_t>(in.tellg()));
+      in.seekg(0);
+      in.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+      if (in && !buffer.empty()) {
+        data = buffer.data();
+        size = buffer.size();
+      }
+#endif
+    }
+
+    ~FileView() {
+#ifdef MACHINA_SNAPSHOT_MMAP
+      if (data) {
+        ::munmap(const_cast<std::byte *>(data), size);
+      }
+#endif
+    }
+
+    FileView(const FileView &) = delete;
+    FileView &operator=(const FileView &) = delete;
+
+    const std::byte *data{nullptr};
+    size_t size{0};
+#ifndef MACHINA_SNAPSHOT_MMAP
+    std::vector<std::byte> buffer{};
+#endif
+  };
+
+  static size_t alignUp(size_t value) {
+    return (value + BLOCK_ALIGN - 1) / BLOCK_ALIGN * BLOCK_ALIGN;
+  }
+
+  // Every offset and count checked against the file size before anything is restored
+  bool validate(const FileView &file) const {
+    Header header;
+    if (file.size < sizeof(Header)) {
+      return false;
+    }
+    std::memcpy(&header, file.data, sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.slotCount > MAX_ENTITIES || header.livingCount > header.slotCount ||
+        sizeof(Header) + header.sectionCount * sizeof(Section) > file.size ||
+        header.slotsOffset > file.size ||
+        header.slotsOffset + (header.slotCount + header.livingCount) * sizeof(Entity) >
+            file.size) {
+      return false;
+    }
+
+    std::vector<Entity> slots(header.slotCount + header.livingCount);
+    std::memcpy(slots.data(), file.data + header.slotsOffset, slots.size() * sizeof(Entity));
+    // living handle of each slot, carrying the generation of its slot
+    std::vector<Entity> handles(header.slotCount, INVALID_ENTITY);
+    for (size_t i{header.slotCount}; i < slots.size(); ++i) {
+      const Entity e = slots[i];
+      if (entityIndex(e) >= header.slotCount || handles[entityIndex(e)] != INVALID_ENTITY ||
+          entityGeneration(e) != (slots[entityIndex(e)] & ENTITY_GENERATION_MASK)) {
+        return false;
+      }
+      handles[entityIndex(e)] = e;
+    }
+
+    std::vector<bool> used(mEntries.size(), false);
+    std::vector<std::uint32_t> owner(header.slotCount, 0);
+    std::vector<Entity> entities;
+    for (std::uint32_t s{0}; s < header.sectionCount; ++s) {
+      Section section;
+      std::memcpy(&section, file.data + sizeof(Header) + s * sizeof(Section), sizeof(Section));
+      const Entry *entry = findEntry(section);
+      if (!entry) {
+        continue;
+      }
+      if (used[entry - mEntries.data()]) {
+        return false;
+      }
+      used[entry - mEntries.data()] = true;
+      if (section.size != entry->size || section.count > header.livingCount ||
+          section.offset > file.size ||
+          section.offset + section.count * (sizeof(Entity) + section.size) > file.size) {
+        return false;
+      }
+
+      // each entity at most once and alive, owner[slot] is the last section listing it
+      entities.resize(section.count);
+      std::memcpy(entities.data(), file.data + section.offset, entities.size() * sizeof(Entity));
+      for (Entity e : entities) {
+        const Entity index = entityIndex(e);
+        if (index >= header.slotCount || handles[index] != e || owner[index] == s + 1) {
+          return false;
+        }
+        owner[index] = s + 1;
+      }
+    }
+    return true;
+  }
+
+  const Entry *findEntry(const Section &section) const {
+    for (const Entry &entry : mEntries) {
+      if (std::strncmp(entry.name.data(), section.name, NAME_SIZE) == 0) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  Centralizer &mCentralizer;
+  std::vector<Entry> mEntries{};
+};
+
+} // namespace ecs
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "../Type/ecs_type.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ecs {
+
+// Entity -> packed index mapping without hashing.
+// The sparse side is split into pages allocated on first use and indexed by
+// entity slot, the dense side keeps every entity handle packed so it can be
+// walked linearly. A stale handle on a recycled slot is not contained.
+class SparseSet {
+public:
+  static constexpr size_t PAGE_SIZE = 4096;
+  static constexpr Entity INVALID_INDEX = std::numeric_limits<Entity>::max();
+
+  bool contains(Entity entity) const {
+    const size_t page = entityIndex(entity) / PAGE_SIZE;
+    if (page >= mSparse.size() || !mSparse[page]) {
+      return false;
+    }
+    const Entity index = (*mSparse[page])[entityIndex(entity) % PAGE_SIZE];
+    return index != INVALID_INDEX && mDense[index] == entity;
+  }
+
+  size_t index(Entity entity) const {
+    assert(contains(entity) && "index : Entity isn't in the sparse set.");
+    return (*mSparse[entityIndex(entity) / PAGE_SIZE])[entityIndex(entity) % PAGE_SIZE];
+  }
+
+  // Return the packed index of the new entity, always the last one
+  size_t insert(Entity entity) {
+    assert(!contains(entity) && "insert : Entity is already in the sparse set.");
+
+    sparseSlot(entity) = static_cast<Entity>(mDense.size());
+    mDense.push_back(entity);
+
+    return mDense.size() - 1;
+  }
+
+  // insert() for `count` entities at once, packed in the same order
+  void insert(const Entity *entities, size_t count) {
+    for (size_t i{0}; i < count; ++i) {
+      assert(!contains(entities[i]) && "insert : Entity is already in the sparse set.");
+      sparseSlot(entities[i]) = static_cast<Entity>(mDense.size() + i);
+    }
+    mDense.insert(mDense.end(), entities, entities + count);
+  }
+
+  void reserve(size_t count) { mDense.reserve(count); }
+
+  // Swap the last entity into the hole, caller has to mirror the move on its own packed data
+  void erase(Entity entity) {
+    const size_t removedIndex = index(entity);
+    const Entity lastEntity = mDense.back();
+
+    mDense[removedIndex] = lastEntity;
+    sparseSlot(lastEntity) = static_cast<Entity>(removedIndex);
+    sparseSlot(entity) = INVALID_INDEX;
+
+    mDense.pop_back();
+  }
+
+  // Exchange two packed entities, caller has to mirror the swap on its own packed data
+  void swap(size_t a, size_t b) {
+    assert(a < mDense.size() && b < mDense.size() && "swap : Index out of range.");
+    std::swap(mDense[a], mDense[b]);
+    sparseSlot(mDense[a]) = static_cast<Entity>(a);
+    sparseSlot(mDense[b]) = static_cast<Entity>(b);
+  }
+
+  // Reorder the packed entities, ascending entity order by default
+  template <typename Compare = std::less<Entity>> void sort(Compare compare = {}) {
+    std::sort(mDense.begin(), mDense.end(), compare);
+    for (size_t i{0}; i < mDense.size(); ++i) {
+      sparseSlot(mDense[i]) = static_cast<Entity>(i);
+    }
+  }
+
+  void clear() {
+    for (Entity entity : mDense) {
+      sparseSlot(entity) = INVALID_INDEX;
+    }
+    mDense.clear();
+  }
+
+  size_t size() const { return mDense.size(); }
+  bool empty() const { return mDense.empty(); }
+
+  size_t memoryUsage() const {
+    size_t pages{0};
+    for (const auto &page : mSparse) {
+      pages += page ? sizeof(Page) : 0;
+    }
+    return pages + mSparse.capacity() * sizeof(mSparse[0]) + mDense.capacity() * sizeof(Entity);
+  }
+
+  const Entity *data() const { return mDense.data(); }
+  std::vector<Entity>::const_iterator begin() const { return mDense.begin(); }
+  std::vector<Entity>::const_iterator end() const { return mDense.end(); }
+
+private:
+  using Page = std::array<Entity, PAGE_SIZE>;
+
+  Entity &sparseSlot(Entity entity) {
+    const size_t page = entityIndex(entity) / PAGE_SIZE;
+    if (page >= mSparse.size()) {
+      mSparse.resize(page + 1);
+    }
+    if (!mSparse[page]) {
+      mSparse[page] = std::make_unique<Page>();
+      mSparse[page]->fill(INVALID_INDEX);
+    }
+    return (*mSparse[page])[entityIndex(entity) % PAGE_SIZE];
+  }
+
+  std::vector<std::unique_ptr<Page>> mSparse{};
+  std::vector<Entity> mDense{};
+};
+
+} // namespace ecs
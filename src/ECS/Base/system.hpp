@@ -1,14 +1,19 @@
 #pragma once
 
 #include "../Type/ecs_type.hpp"
-
-#include <set>
+#include "sparse_set.hpp"
 
 namespace ecs {
 
 class System {
 public:
-  std::set<Entity> mEntities;
+  // Entities matching the system signature, packed in no particular order.
+  // Call mEntities.sort() when an ordered walk is needed.
+  SparseSet mEntities;
+
+  // Components read and written by the system updates, see Scheduler
+  Signature mReads{};
+  Signature mWrites{};
 };
 
-} // namespace ecs
\ No newline at end of file
+} // namespace ecs
@@ -1,59 +1,90 @@
 #pragma once
 
 #include "../Type/ecs_type.hpp"
+#include "../Type/type_id.hpp"
 #include "system.hpp"
 
 #include <cassert>
 #include <memory>
-#include <unordered_map>
+#include <vector>
 
 namespace ecs {
 class SystemManager {
 public:
   template <typename T, typename... Args> std::shared_ptr<T> registerSystem(Args &&...args) {
-    const char *typeName = typeid(T).name();
-    assert(mSystems.find(typeName) == mSystems.end() && "registerSystem : System already exists.");
+    const size_t type = systemTypeId<T>();
+    if (type >= mSystems.size()) {
+      mSystems.resize(type + 1);
+      mSignatures.resize(type + 1);
+    }
+    assert(!mSystems[type] && "registerSystem : System already exists.");
 
     auto sys = std::make_shared<T>(std::forward<Args>(args)...); // Pass arguments to constructor
-    mSystems.insert({typeName, sys});
+    mSystems[type] = sys;
 
     return sys;
   }
 
   template <typename T> void setSignature(Signature signature) {
-    const char *typeName = typeid(T).name();
+    const size_t type = systemTypeId<T>();
 
-    assert(mSystems.find(typeName) != mSystems.end() && "setSignature : System doesn't exist.");
+    assert(type < mSystems.size() && mSystems[type] && "setSignature : System doesn't exist.");
 
-    // if we want to update the signature, maybe use [] operator
-    mSignatures.insert({typeName, signature});
+    mSignatures[type] = signature;
   }
 
   void entityDestroyed(Entity entity) {
     // Erase the entity for each systems
-    for (const auto &e : mSystems) {
-      (e.second)->mEntities.erase(entity);
+    for (const auto &system : mSystems) {
+      if (system && system->mEntities.contains(entity)) {
+        system->mEntities.erase(entity);
+      }
     }
   }
 
   void entitySignatureChanged(Entity entity, Signature entitySignature) {
     // browse every system
-    for (const auto &e : mSystems) {
-      auto const &type = e.first;
-      auto const &system = e.second;
+    for (size_t type{0}; type < mSystems.size(); ++type) {
+      auto const &system = mSystems[type];
       auto const &systemSignature = mSignatures[type];
+      if (!system) {
+        continue;
+      }
 
       // Check if the entity got the bit for the current system
-      if ((entitySignature & systemSignature) == systemSignature) {
-        system->mEntities.insert(entity);
-      } else { // CHECK
-        system->mEntities.erase(entity);
+      const bool matches = (entitySignature & systemSignature) == systemSignature;
+      if (matches != system->mEntities.contains(entity)) {
+        if (matches) {
+          system->mEntities.insert(entity);
+        } else {
+          system->mEntities.erase(entity);
+        }
+      }
+    }
+  }
+
+  // Same as entitySignatureChanged for freshly created entities sharing one signature,
+  // every system is tested once for the whole batch
+  void entitiesSignatureChanged(const Entity *entities, size_t count, Signature entitySignature) {
+    for (size_t type{0}; type < mSystems.size(); ++type) {
+      auto const &system = mSystems[type];
+      auto const &systemSignature = mSignatures[type];
+      if (!system || (entitySignature & systemSignature) != systemSignature) {
+        continue;
+      }
+
+      system->mEntities.reserve(system->mEntities.size() + count);
+      for (size_t i{0}; i < count; ++i) {
+        if (!system->mEntities.contains(entities[i])) {
+          system->mEntities.insert(entities[i]);
+        }
       }
     }
   }
 
 private:
-  std::unordered_map<const char *, Signature> mSignatures{};
-  std::unordered_map<const char *, std::shared_ptr<System>> mSystems{};
+  // Indexed by systemTypeId
+  std::vector<Signature> mSignatures{};
+  std::vector<std::shared_ptr<System>> mSystems{};
 };
-} // namespace ecs
\ No newline at end of file
+} // namespace ecs
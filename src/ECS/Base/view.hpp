@@ -0,0 +1,191 @@
+#pragma once
+
+#include "../Type/ecs_type.hpp"
+#include "archetype.hpp"
+#include "component_array.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ecs {
+
+// Join over several component arrays.
+// With the sparse set backend the smallest array drives the iteration: its
+// packed entities are walked linearly and the other arrays are only probed
+// through their sparse index. With the archetype backend every chunk of the
+// matching archetypes is walked, without any lookup.
+// Adding or removing the viewed components while iterating is not allowed.
+// changedSince / addedSince narrow the iteration to the entities whose component
+// ticks are newer than a given tick, see ComponentTicks.
+template <typename... Ts> class View {
+  static_assert(sizeof...(Ts) > 0, "View : At least one component type is needed.");
+
+  using First = std::tuple_element_t<0, std::tuple<Ts...>>;
+
+public:
+  View(const std::vector<Archetype *> &archetypes, std::array<ComponentType, sizeof...(Ts)> types)
+      : mArchetypes{&archetypes}, mTypes{types} {}
+
+  explicit View(ComponentArray<Ts> *...arrays) : mArrays{arrays...} {
+    assert(((arrays != nullptr) && ...) && "View : Component array missing.");
+
+    size_t smallest = std::numeric_limits<size_t>::max();
+    auto pickDriver = [this, &smallest](const auto *array) {
+      if (array->size() < smallest) {
+        smallest = array->size();
+        mDriver = &array->entities();
+      }
+    };
+    (pickDriver(arrays), ...);
+  }
+
+  // Keep the entities whose T was written after `tick` (added counts as written)
+  template <typename T = First> View changedSince(Tick tick) const {
+    static_assert(indexOf<T>() < sizeof...(Ts), "View : T isn't part of the view.");
+    View view{*this};
+    view.mChangedSince[indexOf<T>()] = tick;
+    view.mFiltered = true;
+    return view;
+  }
+
+  // Keep the entities whose T was added after `tick`
+  template <typename T = First> View addedSince(Tick tick) const {
+    static_assert(indexOf<T>() < sizeof...(Ts), "View : T isn't part of the view.");
+    View view{*this};
+    view.mAddedSince[indexOf<T>()] = tick;
+    view.mFiltered = true;
+    return view;
+  }
+
+  // fn(Entity, Ts &...)
+  template <typename F> void each(F &&fn) const { eachInRange(0, sizeHint(), fn); }
+
+  // Same as each() restricted to the slots [first, last) of [0, sizeHint()).
+  // Disjoint ranges visit disjoint entities, they can be walked by different threads.
+  template <typename F> void eachInRange(size_t first, size_t last, F &&fn) const {
+    if (mArchetypes) {
+      eachChunk(first, last, fn, std::index_sequence_for<Ts...>{});
+      return;
+    }
+
+    const Entity *entities = mDriver->data();
+    last = std::min(last, mDriver->size());
+    for (size_t i{first}; i < last; ++i) {
+      const Entity entity = entities[i];
+      if ((std::get<ComponentArray<Ts> *>(mArrays)->hasData(entity) && ...) &&
+          (!mFiltered || acceptsEntity(entity, i, std::index_sequence_for<Ts...>{}))) {
+        fn(entity, get<Ts>(entity, i)...);
+      }
+    }
+  }
+
+  // Upper bound of the number of entities visited by each()
+  size_t sizeHint() const {
+    if (mArchetypes) {
+      size_t size{0};
+      for (const Archetype *archetype : *mArchetypes) {
+        size += archetype->size();
+      }
+      return size;
+    }
+    return mDriver->size();
+  }
+
+private:
+  template <typename F, size_t... Is>
+  void eachChunk(size_t first, size_t last, F &fn, std::index_sequence<Is...>) const {
+    size_t offset{0};
+    for (Archetype *archetype : *mArchetypes) {
+      for (size_t chunk{0}; chunk < archetype->chunkCount() && offset < last; ++chunk) {
+        const size_t size = archetype->chunkSize(chunk);
+        const size_t begin = std::max(first, offset) - offset;
+        const size_t end = std::min(last, offset + size) - offset;
+        offset += size;
+        if (begin >= end) {
+          continue;
+        }
+
+        const Entity *entities = archetype->entities(chunk);
+        std::tuple<Ts *...> columns{archetype->column<Ts>(chunk, mTypes[Is])...};
+        std::array<const ComponentTicks *, sizeof...(Ts)> ticks{};
+        if (mFiltered) {
+          ticks = {archetype->ticks(chunk, mTypes[Is])...};
+        }
+        for (size_t i{begin}; i < end; ++i) {
+          if (mFiltered && !acceptsRow(ticks, i)) {
+            continue;
+          }
+          fn(entities[i], std::get<Is>(columns)[i]...);
+        }
+      }
+    }
+  }
+
+  template <typename T> static constexpr size_t indexOf() {
+    constexpr bool matches[] = {std::is_same_v<T, Ts>...};
+    size_t index{0};
+    while (index < sizeof...(Ts) && !matches[index]) {
+      ++index;
+    }
+    return index;
+  }
+
+  bool accepts(const ComponentTicks &ticks, size_t i) const {
+    return ticks.changed > mChangedSince[i] && ticks.added > mAddedSince[i];
+  }
+
+  bool unfiltered(size_t i) const { return mChangedSince[i] == 0 && mAddedSince[i] == 0; }
+
+  template <size_t... Is>
+  bool acceptsEntity(Entity entity, size_t driverIndex, std::index_sequence<Is...>) const {
+    auto acceptsType = [&](auto *array, size_t i) {
+      if (unfiltered(i)) {
+        return true;
+      }
+      // no lookup for the array we are walking
+      return accepts(&array->entities() == mDriver ? array->getTicksAt(driverIndex)
+                                                   : array->getTicks(entity),
+                     i);
+    };
+    return (acceptsType(std::get<Is>(mArrays), Is) && ...);
+  }
+
+  bool acceptsRow(const std::array<const ComponentTicks *, sizeof...(Ts)> &ticks,
+                  size_t row) const {
+    for (size_t i{0}; i < sizeof...(Ts); ++i) {
+      if (!unfiltered(i) && !accepts(ticks[i][row], i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template <typename T> T &get(Entity entity, size_t driverIndex) const {
+    ComponentArray<T> *array = std::get<ComponentArray<T> *>(mArrays);
+    // no lookup at all for the array we are walking
+    if (&array->entities() == mDriver) {
+      return array->getDataAt(driverIndex);
+    }
+    return array->getData(entity);
+  }
+
+  std::tuple<ComponentArray<Ts> *...> mArrays{};
+  const SparseSet *mDriver{nullptr};
+
+  const std::vector<Archetype *> *mArchetypes{nullptr};
+  std::array<ComponentType, sizeof...(Ts)> mTypes{};
+
+  // 0 when the type isn't filtered
+  std::array<Tick, sizeof...(Ts)> mChangedSince{};
+  std::array<Tick, sizeof...(Ts)> mAddedSince{};
+  bool mFiltered{false};
+};
+
+} // namespace ecs
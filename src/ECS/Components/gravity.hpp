@@ -4,7 +4,8 @@
 
 namespace ecs {
 
-const float GRAVITY_CONSTANT = 8.91 / 60; // 60 IS FPS
+// per second, integrated with the fixed simulation step
+const float GRAVITY_CONSTANT = 8.91f;
 
 struct Gravity {
   glm::vec3 force;
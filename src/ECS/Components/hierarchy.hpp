@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../Type/ecs_type.hpp"
+
+#include <vector>
+
+namespace ecs {
+
+// Relationship pair kept in sync by HierarchySystem::attach / detach, don't edit by hand.
+// Every entity of a hierarchy owns a WorldMatrix, children also own a LocalTransform.
+struct Parent {
+  Entity entity{INVALID_ENTITY};
+};
+
+struct Children {
+  std::vector<Entity> entities{};
+};
+
+} // namespace ecs
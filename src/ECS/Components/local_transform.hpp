@@ -0,0 +1,12 @@
+#pragma once
+
+#include "transform.hpp"
+
+namespace ecs {
+
+// Transform of a child relative to its Parent, written through the Transform mutators.
+// The HierarchySystem composes it with the parent WorldMatrix, the Transform of the child
+// then only mirrors its world position.
+struct LocalTransform : Transform {};
+
+} // namespace ecs
@@ -1,15 +1,19 @@
 #pragma once
 
-#include <glm/vec3.hpp>
-
-#include <memory>
-
-#include "../../vulkan/model.hpp"
+#include <cstdint>
+#include <type_traits>
 
 namespace ecs {
 
+// Index of a mesh in the vu::MeshRegistry of the app
+using MeshHandle = std::uint32_t;
+constexpr MeshHandle INVALID_MESH = UINT32_MAX;
+
+// Plain handle, the mesh itself is owned by the registry
 struct Model {
-  std::shared_ptr<vu::Model> model{};
+  MeshHandle mesh{INVALID_MESH};
 };
 
-} // namespace ecs
\ No newline at end of file
+static_assert(std::is_trivially_copyable_v<Model>, "Model : Must stay trivially copyable.");
+
+} // namespace ecs
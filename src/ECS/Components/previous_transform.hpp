@@ -0,0 +1,11 @@
+#pragma once
+
+#include "transform.hpp"
+
+namespace ecs {
+
+// Transform of the entity before the last fixed simulation step. The TransformSystem
+// saves it before each step and renders the entity in between the two states.
+struct PreviousTransform : Transform {};
+
+} // namespace ecs
@@ -5,47 +5,79 @@
 
 namespace ecs {
 
+// Written through the mutators only, they flag the WorldMatrix of the entity for a rebuild
 struct Transform {
-  glm::vec3 position;
-  glm::vec3 rotation;
-  glm::vec3 scale{1.f, 1.f, 1.f};
+  Transform(const glm::vec3 &position = {}, const glm::vec3 &rotation = {},
+            const glm::vec3 &scale = {1.f, 1.f, 1.f})
+      : mPosition{position}, mRotation{rotation}, mScale{scale} {}
 
-  glm::mat4 mat4() {
-    const float c3 = glm::cos(rotation.z);
-    const float s3 = glm::sin(rotation.z);
-    const float c2 = glm::cos(rotation.x);
-    const float s2 = glm::sin(rotation.x);
-    const float c1 = glm::cos(rotation.y);
-    const float s1 = glm::sin(rotation.y);
+  const glm::vec3 &position() const { return mPosition; }
+  const glm::vec3 &rotation() const { return mRotation; }
+  const glm::vec3 &scale() const { return mScale; }
+
+  void setPosition(const glm::vec3 &value) {
+    mPosition = value;
+    dirty = true;
+  }
+
+  void translate(const glm::vec3 &offset) {
+    mPosition += offset;
+    dirty = true;
+  }
+
+  void setRotation(const glm::vec3 &value) {
+    mRotation = value;
+    dirty = true;
+  }
+
+  void setScale(const glm::vec3 &value) {
+    mScale = value;
+    dirty = true;
+  }
+
+  // Unflagged write for the HierarchySystem, which builds the WorldMatrix of a child itself
+  // and keeps its Transform as a mirror of the world position
+  void mirrorWorldPosition(const glm::vec3 &value) { mPosition = value; }
+
+  // cleared by the TransformSystem once the WorldMatrix is up to date
+  bool dirty{true};
+
+  glm::mat4 mat4() const {
+    const float c3 = glm::cos(mRotation.z);
+    const float s3 = glm::sin(mRotation.z);
+    const float c2 = glm::cos(mRotation.x);
+    const float s2 = glm::sin(mRotation.x);
+    const float c1 = glm::cos(mRotation.y);
+    const float s1 = glm::sin(mRotation.y);
     return glm::mat4{{
-                         scale.x * (c1 * c3 + s1 * s2 * s3),
-                         scale.x * (c2 * s3),
-                         scale.x * (c1 * s2 * s3 - c3 * s1),
+                         mScale.x * (c1 * c3 + s1 * s2 * s3),
+                         mScale.x * (c2 * s3),
+                         mScale.x * (c1 * s2 * s3 - c3 * s1),
                          0.0f,
                      },
                      {
-                         scale.y * (c3 * s1 * s2 - c1 * s3),
-                         scale.y * (c2 * c3),
-                         scale.y * (c1 * c3 * s2 + s1 * s3),
+                         mScale.y * (c3 * s1 * s2 - c1 * s3),
+                         mScale.y * (c2 * c3),
+                         mScale.y * (c1 * c3 * s2 + s1 * s3),
                          0.0f,
                      },
                      {
-                         scale.z * (c2 * s1),
-                         scale.z * (-s2),
-                         scale.z * (c1 * c2),
+                         mScale.z * (c2 * s1),
+                         mScale.z * (-s2),
+                         mScale.z * (c1 * c2),
                          0.0f,
                      },
-                     {position.x, position.y, position.z, 1.0f}};
+                     {mPosition.x, mPosition.y, mPosition.z, 1.0f}};
   }
 
-  glm::mat3 normalMatrix() {
-    const float c3 = glm::cos(rotation.z);
-    const float s3 = glm::sin(rotation.z);
-    const float c2 = glm::cos(rotation.x);
-    const float s2 = glm::sin(rotation.x);
-    const float c1 = glm::cos(rotation.y);
-    const float s1 = glm::sin(rotation.y);
-    const glm::vec3 invScale = 1.0f / scale;
+  glm::mat3 normalMatrix() const {
+    const float c3 = glm::cos(mRotation.z);
+    const float s3 = glm::sin(mRotation.z);
+    const float c2 = glm::cos(mRotation.x);
+    const float s2 = glm::sin(mRotation.x);
+    const float c1 = glm::cos(mRotation.y);
+    const float s1 = glm::sin(mRotation.y);
+    const glm::vec3 invScale = 1.0f / mScale;
 
     return glm::mat3{
         {
@@ -65,6 +97,11 @@ struct Transform {
         },
     };
   }
+
+private:
+  glm::vec3 mPosition;
+  glm::vec3 mRotation;
+  glm::vec3 mScale;
 };
 
 } // namespace ecs
\ No newline at end of file
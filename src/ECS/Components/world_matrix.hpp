@@ -0,0 +1,17 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+
+namespace ecs {
+
+// Matrices of the entity Transform, rebuilt by the TransformSystem when it is dirty
+struct WorldMatrix {
+  glm::mat4 model{1.f};
+  glm::mat4 normal{1.f};
+  // bumped on every rebuild, the HierarchySystem compares it to find the roots that moved
+  std::uint32_t version{0};
+};
+
+} // namespace ecs
@@ -1,24 +1,43 @@
 #pragma once
 
 #include "Type/ecs_type.hpp"
+#include "Type/type_id.hpp"
 
+#include "Base/archetype.hpp"
+#include "Base/archetype_storage.hpp"
 #include "Base/centralizer.hpp"
+#include "Base/command_buffer.hpp"
 #include "Base/component_array.hpp"
 #include "Base/component_manager.hpp"
 #include "Base/entity_manager.hpp"
+#include "Base/fixed_timestep.hpp"
+#include "Base/group.hpp"
+#include "Base/job_system.hpp"
+#include "Base/observers.hpp"
+#include "Base/prefab.hpp"
+#include "Base/scheduler.hpp"
+#include "Base/snapshot.hpp"
+#include "Base/sparse_set.hpp"
 #include "Base/system.hpp"
 #include "Base/system_manager.hpp"
+#include "Base/view.hpp"
 
 #include "Systems/camera_system.hpp"
 #include "Systems/gravity_system.hpp"
+#include "Systems/hierarchy_system.hpp"
 #include "Systems/point_light_system.hpp"
 #include "Systems/render_system.hpp"
 #include "Systems/simple_render_system.hpp"
+#include "Systems/transform_system.hpp"
 
 #include "Components/camera.hpp"
 #include "Components/color.hpp"
 #include "Components/gravity.hpp"
+#include "Components/hierarchy.hpp"
+#include "Components/local_transform.hpp"
 #include "Components/model.hpp"
 #include "Components/point_light.hpp"
+#include "Components/previous_transform.hpp"
 #include "Components/rigid_body.hpp"
 #include "Components/transform.hpp"
+#include "Components/world_matrix.hpp"
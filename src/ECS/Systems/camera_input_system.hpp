@@ -6,35 +6,20 @@
 #include "../Components/camera.hpp"
 #include "../Components/transform.hpp"
 
-#include "../../vulkan/window.hpp"
-
-using namespace vu;
+#include "../../input/input_state.hpp"
 
 namespace ecs {
 class CameraInputSystem : public System {
 public:
-  struct KeyMappings {
-    int moveLeft = GLFW_KEY_A;
-    int moveRight = GLFW_KEY_D;
-    int moveForward = GLFW_KEY_W;
-    int moveBackward = GLFW_KEY_S;
-    int moveUp = GLFW_KEY_SPACE;
-    int moveDown = GLFW_KEY_LEFT_SHIFT;
-    int lookLeft = GLFW_KEY_LEFT;
-    int lookRight = GLFW_KEY_RIGHT;
-    int lookUp = GLFW_KEY_UP;
-    int lookDown = GLFW_KEY_DOWN;
-  };
-
-  CameraInputSystem(GLFWwindow *window);
+  explicit CameraInputSystem(Centralizer &centralizer);
 
-  void update(float dt);
+  // Fly the cameras from the buttons held this frame
+  void update(float dt, const vu::InputState &input);
 
-  KeyMappings mKeys{};
   float mMoveSpeed{10.f};
   float mLookSpeed{2.5f};
 
 private:
-  GLFWwindow *mWindow;
+  Centralizer &mCentralizer;
 };
 } // namespace ecs
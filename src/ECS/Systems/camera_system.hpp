@@ -8,14 +8,12 @@
 #include "../Components/camera.hpp"
 #include "../Components/transform.hpp"
 
-#include "../../vulkan/frame_info.hpp"
-
-using namespace vu;
-
 namespace ecs {
 class CameraSystem : public System {
 
 public:
+  explicit CameraSystem(Centralizer &centralizer);
+
   void lookAt(Entity cameraEntity, const glm::vec3 &direction);
 
   void update(GlobalUbo &ubo, float aspect, Entity e);
@@ -24,5 +22,7 @@ public:
 
 private:
   void setViewYXZ(Entity e);
+
+  Centralizer &mCentralizer;
 };
 } // namespace ecs
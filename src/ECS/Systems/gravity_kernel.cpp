@@ -0,0 +1,98 @@
+#include "gravity_kernel.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MACHINA_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace ecs {
+
+namespace {
+
+using Kernel = void (*)(const BodyAxis &, const float *, size_t, float, size_t);
+
+// Bodies [first, count)
+void integrateScalar(const BodyAxis &axis, const float *mass, size_t count, float dt,
+                     size_t first) {
+  for (size_t i{first}; i < count; ++i) {
+    axis.acceleration[i] -= axis.force[i] * mass[i] * dt;
+    axis.velocity[i] += axis.acceleration[i] * dt;
+    axis.position[i] += axis.velocity[i] * dt;
+  }
+}
+
+#ifdef MACHINA_X86_KERNELS
+// no fma on purpose, it would round differently than the scalar tail
+__attribute__((target("sse"))) void integrateSse(const BodyAxis &axis, const float *mass,
+                                                 size_t count, float dt, size_t first) {
+  const __m128 step = _mm_set1_ps(dt);
+  size_t i{first};
+  for (; i + 4 <= count; i += 4) {
+    __m128 acceleration = _mm_loadu_ps(axis.acceleration + i);
+    acceleration = _mm_sub_ps(
+        acceleration,
+        _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(axis.force + i), _mm_loadu_ps(mass + i)), step));
+    const __m128 velocity =
+        _mm_add_ps(_mm_loadu_ps(axis.velocity + i), _mm_mul_ps(acceleration, step));
+    const __m128 position = _mm_add_ps(_mm_loadu_ps(axis.position + i), _mm_mul_ps(velocity, step));
+    _mm_storeu_ps(axis.acceleration + i, acceleration);
+    _mm_storeu_ps(axis.velocity + i, velocity);
+    _mm_storeu_ps(axis.position + i, position);
+  }
+  integrateScalar(axis, mass, count, dt, i);
+}
+
+__attribute__((target("avx2"))) void integrateAvx2(const BodyAxis &axis, const float *mass,
+                                                   size_t count, float dt, size_t first) {
+  const __m256 step = _mm256_set1_ps(dt);
+  size_t i{first};
+  for (; i + 8 <= count; i += 8) {
+    __m256 acceleration = _mm256_loadu_ps(axis.acceleration + i);
+    acceleration = _mm256_sub_ps(
+        acceleration,
+        _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(axis.force + i), _mm256_loadu_ps(mass + i)),
+                      step));
+    const __m256 velocity =
+        _mm256_add_ps(_mm256_loadu_ps(axis.velocity + i), _mm256_mul_ps(acceleration, step));
+    const __m256 position =
+        _mm256_add_ps(_mm256_loadu_ps(axis.position + i), _mm256_mul_ps(velocity, step));
+    _mm256_storeu_ps(axis.acceleration + i, acceleration);
+    _mm256_storeu_ps(axis.velocity + i, velocity);
+    _mm256_storeu_ps(axis.position + i, position);
+  }
+  integrateSse(axis, mass, count, dt, i);
+}
+#endif
+
+struct SelectedKernel {
+  Kernel kernel;
+  const char *name;
+};
+
+SelectedKernel selectKernel() {
+#ifdef MACHINA_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return {integrateAvx2, "avx2"};
+  }
+  if (__builtin_cpu_supports("sse")) {
+    return {integrateSse, "sse"};
+  }
+#endif
+  return {integrateScalar, "scalar"};
+}
+
+const SelectedKernel &selectedKernel() {
+  static const SelectedKernel selected = selectKernel();
+  return selected;
+}
+
+} // namespace
+
+void integrateBodies(const BodyAxis &axis, const float *mass, size_t count, float dt) {
+  selectedKernel().kernel(axis, mass, count, dt, 0);
+}
+
+const char *gravityKernelName() { return selectedKernel().name; }
+
+} // namespace ecs
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ecs {
+
+// One axis of a block of falling bodies, stored as structure of arrays
+struct BodyAxis {
+  float *position;
+  float *velocity;
+  float *acceleration;
+  const float *force;
+};
+
+// acceleration -= force * mass * dt, velocity += acceleration * dt, position += velocity * dt
+// for `count` bodies. The widest kernel the CPU supports is picked on first call:
+// AVX2 (8 bodies per instruction), SSE (4) or scalar. Every kernel gives the same results.
+void integrateBodies(const BodyAxis &axis, const float *mass, size_t count, float dt);
+
+// "avx2", "sse" or "scalar"
+const char *gravityKernelName();
+
+} // namespace ecs
@@ -1,22 +1,194 @@
 #include "gravity_system.hpp"
 
-extern std::unique_ptr<ecs::Centralizer> gCentralizer;
+#include "../../profiler/profiler.hpp"
+#include "gravity_kernel.hpp"
 
 namespace ecs {
 
-GravitySystem::GravitySystem() {}
+GravitySystem::GravitySystem(Centralizer &centralizer, GravityIntegration integration)
+    : mCentralizer{centralizer}, mIntegration{integration} {
+  mReads = componentSignature<ecs::Gravity>();
+  mWrites = componentSignature<ecs::RigidBody, ecs::Transform>();
+}
+
+void GravitySystem::update(float dt) {
+  PROFILE_ZONE("GravitySystem::update");
+  if (mIntegration == GravityIntegration::SoA) {
+    integrateSoA(dt);
+  } else {
+    integratePerEntity(dt);
+  }
+}
+
+void GravitySystem::integratePerEntity(float dt) {
+  // every body only touches its own components
+  mCentralizer.getJobSystem().parallelFor(
+      mCentralizer.view<ecs::Gravity, ecs::RigidBody, ecs::Transform>(), CHUNK_SIZE,
+      [&](Entity e, ecs::Gravity &gravity, ecs::RigidBody &rigidBody, ecs::Transform &transform) {
+        rigidBody.acceleration -= gravity.force * rigidBody.mass * dt;
+        rigidBody.velocity += rigidBody.acceleration * dt;
+        transform.translate(rigidBody.velocity * dt);
+        // rigidBody.acceleration = glm::vec3{0.f, 0.f, 0.f};
+      });
+}
+
+void GravitySystem::integrateSoA(float dt) {
+  JobSystem &jobs = mCentralizer.getJobSystem();
+  ++mFrame;
+
+  // Ticks only tell the frame of a write, so the writes of the current tick are pulled
+  // again by the next steps. Writing the RigidBody of the pulled bodies back makes that a
+  // no-op, Transform::position is published every step anyway.
+  pullChanged<ecs::Gravity>();
+  pullChanged<ecs::RigidBody>();
+  pullChanged<ecs::Transform>();
+  mPullTick = mCentralizer.getTick() - 1;
+
+  integrateBodies(0, mBodyEntities.size(), dt);
+  for (uint32_t slot : mPulled) {
+    writeBackRigidBody(slot);
+  }
+  mPulled.clear();
 
-void GravitySystem::update(FrameInfo &frameInfo) {
-  for (const Entity &e : mEntities) {
-    auto &gravity = gCentralizer->getComponent<ecs::Gravity>(e);
-    auto &rigidBody = gCentralizer->getComponent<ecs::RigidBody>(e);
-    auto &transform = gCentralizer->getComponent<ecs::Transform>(e);
+  // publish the positions and find out which bodies joined or left the view
+  auto view = mCentralizer.view<ecs::Gravity, ecs::RigidBody, ecs::Transform>();
+  const size_t count = view.sizeHint();
+  std::vector<std::vector<Entity>> joined((count + CHUNK_SIZE - 1) / CHUNK_SIZE);
+  jobs.parallelFor(count, CHUNK_SIZE, [&](size_t begin, size_t end) {
+    view.eachInRange(begin, end, [&](Entity e, ecs::Gravity &, ecs::RigidBody &,
+                                     ecs::Transform &transform) {
+      const uint32_t slot = findBody(e);
+      if (slot == NO_BODY) {
+        joined[begin / CHUNK_SIZE].push_back(e);
+        return;
+      }
+      mSeen[slot] = mFrame;
+      transform.setPosition({mPosition[0][slot], mPosition[1][slot], mPosition[2][slot]});
+    });
+  });
+
+  // backwards, the body swapped into a freed slot was already checked
+  for (size_t slot{mBodyEntities.size()}; slot-- > 0;) {
+    if (mSeen[slot] != mFrame) {
+      removeBody(static_cast<uint32_t>(slot));
+    }
+  }
+
+  const size_t first = mBodyEntities.size();
+  for (const std::vector<Entity> &entities : joined) {
+    for (Entity e : entities) {
+      addBody(e);
+    }
+  }
+  integrateBodies(first, mBodyEntities.size(), dt);
+  for (size_t slot{first}; slot < mBodyEntities.size(); ++slot) {
+    auto &transform = mCentralizer.getComponent<ecs::Transform>(mBodyEntities[slot]);
+    transform.setPosition({mPosition[0][slot], mPosition[1][slot], mPosition[2][slot]});
+    // joined this tick, the next steps pull them again
+    writeBackRigidBody(static_cast<uint32_t>(slot));
+  }
+}
+
+template <typename T> void GravitySystem::pullChanged() {
+  mCentralizer.view<ecs::Gravity, ecs::RigidBody, ecs::Transform>()
+      .template changedSince<T>(mPullTick)
+      .each([this](Entity e, ecs::Gravity &, ecs::RigidBody &, ecs::Transform &) {
+        // bodies joining this step are loaded by addBody
+        if (const uint32_t slot = findBody(e); slot != NO_BODY) {
+          loadBody(slot, e);
+          mPulled.push_back(slot);
+        }
+      });
+}
+
+void GravitySystem::loadBody(uint32_t slot, Entity entity) {
+  const auto &gravity = mCentralizer.getComponent<ecs::Gravity>(entity);
+  const auto &rigidBody = mCentralizer.getComponent<ecs::RigidBody>(entity);
+  const auto &transform = mCentralizer.getComponent<ecs::Transform>(entity);
+  for (int k{0}; k < 3; ++k) {
+    mPosition[k][slot] = transform.position()[k];
+    mVelocity[k][slot] = rigidBody.velocity[k];
+    mAcceleration[k][slot] = rigidBody.acceleration[k];
+    mForce[k][slot] = gravity.force[k];
+  }
+  mMass[slot] = rigidBody.mass;
+}
+
+void GravitySystem::writeBackRigidBodies() {
+  for (size_t slot{0}; slot < mBodyEntities.size(); ++slot) {
+    writeBackRigidBody(static_cast<uint32_t>(slot));
+  }
+}
+
+void GravitySystem::writeBackRigidBody(uint32_t slot) {
+  auto &rigidBody = mCentralizer.getComponent<ecs::RigidBody>(mBodyEntities[slot]);
+  for (int k{0}; k < 3; ++k) {
+    rigidBody.velocity[k] = mVelocity[k][slot];
+    rigidBody.acceleration[k] = mAcceleration[k][slot];
+  }
+}
+
+void GravitySystem::integrateBodies(size_t first, size_t last, float dt) {
+  mCentralizer.getJobSystem().parallelFor(last - first, CHUNK_SIZE, [&](size_t begin, size_t end) {
+    begin += first;
+    end += first;
+    for (int k{0}; k < 3; ++k) {
+      ecs::integrateBodies(BodyAxis{mPosition[k].data() + begin, mVelocity[k].data() + begin,
+                                    mAcceleration[k].data() + begin, mForce[k].data() + begin},
+                           mMass.data() + begin, end - begin, dt);
+    }
+  });
+}
+
+uint32_t GravitySystem::findBody(Entity entity) const {
+  const uint32_t index = entityIndex(entity);
+  if (index >= mSlots.size() || mSlots[index] == NO_BODY) {
+    return NO_BODY;
+  }
+  // the index may have been recycled
+  return mBodyEntities[mSlots[index]] == entity ? mSlots[index] : NO_BODY;
+}
+
+void GravitySystem::addBody(Entity entity) {
+  const uint32_t index = entityIndex(entity);
+  if (index >= mSlots.size()) {
+    mSlots.resize(index + 1, NO_BODY);
+  }
+  const auto slot = static_cast<uint32_t>(mBodyEntities.size());
+  mSlots[index] = slot;
+
+  for (int k{0}; k < 3; ++k) {
+    mPosition[k].emplace_back();
+    mVelocity[k].emplace_back();
+    mAcceleration[k].emplace_back();
+    mForce[k].emplace_back();
+  }
+  mMass.emplace_back();
+  mBodyEntities.push_back(entity);
+  loadBody(slot, entity);
+  mSeen.push_back(mFrame);
+}
+
+void GravitySystem::removeBody(uint32_t slot) {
+  const uint32_t last = static_cast<uint32_t>(mBodyEntities.size() - 1);
+  mSlots[entityIndex(mBodyEntities[slot])] = NO_BODY;
+  if (slot != last) {
+    mSlots[entityIndex(mBodyEntities[last])] = slot;
+  }
 
-    rigidBody.acceleration -= gravity.force * rigidBody.mass;
-    rigidBody.velocity += rigidBody.acceleration * frameInfo.frameTime;
-    transform.position += rigidBody.velocity * frameInfo.frameTime;
-    // rigidBody.acceleration = glm::vec3{0.f, 0.f, 0.f};
+  auto swapPop = [slot, last](auto &values) {
+    values[slot] = values[last];
+    values.pop_back();
+  };
+  for (int k{0}; k < 3; ++k) {
+    swapPop(mPosition[k]);
+    swapPop(mVelocity[k]);
+    swapPop(mAcceleration[k]);
+    swapPop(mForce[k]);
   }
+  swapPop(mMass);
+  swapPop(mBodyEntities);
+  swapPop(mSeen);
 }
 
 } // namespace ecs
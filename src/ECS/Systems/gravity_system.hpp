@@ -7,15 +7,72 @@
 #include "../Components/rigid_body.hpp"
 #include "../Components/transform.hpp"
 
-#include "../../vulkan/frame_info.hpp"
-
-using namespace vu;
+// std
+#include <array>
+#include <cstdint>
+#include <vector>
 
 namespace ecs {
+
+// PerEntity integrates every body through the glm::vec3 members of its components.
+// SoA keeps the bodies in per axis float arrays owned by the system and integrates them
+// with the vectorized kernel of gravity_kernel.hpp. Only Transform::position is written
+// back each frame, see GravitySystem::writeBackRigidBodies.
+// Outside writes to the Gravity, RigidBody or Transform of a SoA body only reach it when
+// they are flagged (Centralizer::patch or markChanged, see View::changedSince), the body
+// is then reloaded from its components before the next step. Unflagged writes to
+// Transform::position or RigidBody are overwritten.
+enum class GravityIntegration { PerEntity, SoA };
+
 class GravitySystem : public System {
 public:
-  GravitySystem();
+  explicit GravitySystem(Centralizer &centralizer,
+                         GravityIntegration integration = GravityIntegration::PerEntity);
+
+  // One fixed simulation step of dt seconds
+  void update(float dt);
+
+  // SoA only: Gravity and RigidBody are read when a body joins the system or when they are
+  // flagged as changed. Copies the live velocity and acceleration back to the RigidBody
+  // components.
+  void writeBackRigidBodies();
+
+private:
+  void integratePerEntity(float dt);
+  void integrateSoA(float dt);
+
+  // SoA bookkeeping
+  void integrateBodies(size_t first, size_t last, float dt);
+  template <typename T> void pullChanged();
+  void loadBody(uint32_t slot, Entity entity);
+  void writeBackRigidBody(uint32_t slot);
+  uint32_t findBody(Entity entity) const;
+  void addBody(Entity entity);
+  void removeBody(uint32_t slot);
+
+  Centralizer &mCentralizer;
+  GravityIntegration mIntegration;
+
+  // bodies integrated per job
+  static constexpr size_t CHUNK_SIZE = 1024;
+
+  static constexpr uint32_t NO_BODY = UINT32_MAX;
 
-  void update(FrameInfo &frameInfo);
+  // SoA bodies, one float array per axis and quantity
+  std::array<std::vector<float>, 3> mPosition{};
+  std::array<std::vector<float>, 3> mVelocity{};
+  std::array<std::vector<float>, 3> mAcceleration{};
+  std::array<std::vector<float>, 3> mForce{};
+  std::vector<float> mMass{};
+  std::vector<Entity> mBodyEntities{};
+  // last update the body was found in the view
+  std::vector<uint32_t> mSeen{};
+  uint32_t mFrame{0};
+  // bodies reloaded by this step, their RigidBody is kept in sync with the SoA
+  std::vector<uint32_t> mPulled{};
+  // writes flagged after this tick are pulled by the next step
+  Tick mPullTick{0};
+  // body slot by entity index
+  std::vector<uint32_t> mSlots{};
 };
 } // namespace ecs
@@ -0,0 +1,193 @@
+#include "hierarchy_system.hpp"
+
+#include "../../profiler/profiler.hpp"
+
+// std
+#include <algorithm>
+#include <cassert>
+
+namespace ecs {
+
+HierarchySystem::HierarchySystem(Centralizer &centralizer) : mCentralizer{centralizer} {
+  mReads = componentSignature<ecs::Parent, ecs::Children>();
+  // clearing the dirty flag writes the LocalTransform
+  mWrites = componentSignature<ecs::LocalTransform, ecs::Transform, ecs::WorldMatrix>();
+
+  // destroyed entities show up in the removals of their Parent or Children
+  mCentralizer.onRemove<ecs::Parent>(
+      [this](const std::vector<Entity> &entities) { unlinkDestroyed(entities); });
+  mCentralizer.onRemove<ecs::Children>(
+      [this](const std::vector<Entity> &entities) { unlinkDestroyed(entities); });
+}
+
+void HierarchySystem::attach(Centralizer &centralizer, Entity child, Entity parent) {
+  assert(child != parent && "attach : An entity can't be its own parent.");
+  assert(centralizer.isAlive(child) && centralizer.isAlive(parent) &&
+         "attach : Entity is not alive.");
+  // rebuild only walks roots owning a WorldMatrix and children owning all three
+  assert(centralizer.hasComponent<ecs::WorldMatrix>(parent) &&
+         "attach : The parent has no WorldMatrix.");
+  assert(centralizer.hasComponent<ecs::WorldMatrix>(child) &&
+         centralizer.hasComponent<ecs::LocalTransform>(child) &&
+         centralizer.hasComponent<ecs::Transform>(child) &&
+         "attach : The child needs a WorldMatrix, a LocalTransform and a Transform.");
+  for (Entity e = parent; centralizer.hasComponent<ecs::Parent>(e);) {
+    e = centralizer.getComponent<ecs::Parent>(e).entity;
+    assert(e != child && "attach : The parent is a descendant of the child.");
+  }
+
+  if (centralizer.hasComponent<ecs::Parent>(child)) {
+    detach(centralizer, child);
+  }
+  centralizer.addComponent(child, ecs::Parent{parent});
+
+  if (!centralizer.hasComponent<ecs::Children>(parent)) {
+    centralizer.addComponent(parent, ecs::Children{});
+  }
+  centralizer.patch<ecs::Children>(
+      parent, [child](ecs::Children &children) { children.entities.push_back(child); });
+}
+
+void HierarchySystem::detach(Centralizer &centralizer, Entity child) {
+  const Entity parent = centralizer.getComponent<ecs::Parent>(child).entity;
+  centralizer.removeComponent<ecs::Parent>(child);
+
+  if (!centralizer.isAlive(parent)) {
+    return;
+  }
+  auto &entities = centralizer.getComponent<ecs::Children>(parent).entities;
+  entities.erase(std::find(entities.begin(), entities.end(), child));
+  if (entities.empty()) {
+    centralizer.removeComponent<ecs::Children>(parent);
+  } else {
+    centralizer.markChanged<ecs::Children>(parent);
+  }
+}
+
+void HierarchySystem::unlinkDestroyed(const std::vector<Entity> &entities) {
+  const auto dead = [this](Entity e) { return !mCentralizer.isAlive(e); };
+  if (std::none_of(entities.begin(), entities.end(), dead)) {
+    return;
+  }
+
+  // collected first, the views can't be walked while components come and go
+  std::vector<Entity> parents;
+  mCentralizer.view<ecs::Children>().each([&](Entity e, ecs::Children &children) {
+    if (std::any_of(children.entities.begin(), children.entities.end(), dead)) {
+      parents.push_back(e);
+    }
+  });
+  std::vector<Entity> orphans;
+  mCentralizer.view<ecs::Parent>().each([&](Entity e, ecs::Parent &parent) {
+    if (dead(parent.entity)) {
+      orphans.push_back(e);
+    }
+  });
+
+  for (Entity parent : parents) {
+    auto &children = mCentralizer.getComponent<ecs::Children>(parent).entities;
+    std::erase_if(children, dead);
+    if (children.empty()) {
+      mCentralizer.removeComponent<ecs::Children>(parent);
+    } else {
+      mCentralizer.markChanged<ecs::Children>(parent);
+    }
+  }
+  // like detach, an orphan keeps its last world matrix and becomes a root
+  for (Entity orphan : orphans) {
+    mCentralizer.removeComponent<ecs::Parent>(orphan);
+  }
+}
+
+bool HierarchySystem::isNode(Entity child) {
+  return mCentralizer.isAlive(child) && mCentralizer.hasComponent<ecs::WorldMatrix>(child) &&
+         mCentralizer.hasComponent<ecs::LocalTransform>(child) &&
+         mCentralizer.hasComponent<ecs::Transform>(child);
+}
+
+void HierarchySystem::update() {
+  PROFILE_ZONE("HierarchySystem::update");
+  const bool all = mStructureVersion != mCentralizer.getStructureVersion();
+  if (all) {
+    rebuild();
+    mStructureVersion = mCentralizer.getStructureVersion();
+  }
+  if (mNodes.empty()) {
+    return;
+  }
+
+  mCentralizer.getJobSystem().parallelFor(
+      mSubtrees.size() - 1, SUBTREES_PER_JOB, [&](size_t first, size_t last) {
+        for (size_t subtree{first}; subtree < last; ++subtree) {
+          propagate(mSubtrees[subtree], mSubtrees[subtree + 1], all);
+        }
+      });
+}
+
+void HierarchySystem::rebuild() {
+  mNodes.clear();
+  mSubtrees.clear();
+
+  std::vector<Entity> roots;
+  mCentralizer.view<ecs::Children, ecs::WorldMatrix>().each(
+      [&](Entity e, ecs::Children &, ecs::WorldMatrix &) {
+        // the parent may be destroyed and not unlinked yet
+        if (!mCentralizer.hasComponent<ecs::Parent>(e) ||
+            !mCentralizer.isAlive(mCentralizer.getComponent<ecs::Parent>(e).entity)) {
+          roots.push_back(e);
+        }
+      });
+
+  // breadth first per root, a parent always comes before its children
+  std::vector<Entity> entities;
+  for (Entity root : roots) {
+    mSubtrees.push_back(static_cast<std::uint32_t>(mNodes.size()));
+    mNodes.push_back(
+        Node{NO_PARENT, &mCentralizer.getComponent<ecs::WorldMatrix>(root), nullptr, nullptr, 0});
+    entities.push_back(root);
+
+    for (size_t i{mSubtrees.back()}; i < mNodes.size(); ++i) {
+      if (!mCentralizer.hasComponent<ecs::Children>(entities[i])) {
+        continue;
+      }
+      for (Entity child : mCentralizer.getComponent<ecs::Children>(entities[i]).entities) {
+        // destroyed children are unlinked at the next event dispatch, skipped until then
+        if (!isNode(child)) {
+          continue;
+        }
+        mNodes.push_back(Node{static_cast<std::uint32_t>(i),
+                              &mCentralizer.getComponent<ecs::WorldMatrix>(child),
+                              &mCentralizer.getComponent<ecs::LocalTransform>(child),
+                              &mCentralizer.getComponent<ecs::Transform>(child), 0});
+        entities.push_back(child);
+      }
+    }
+  }
+  mSubtrees.push_back(static_cast<std::uint32_t>(mNodes.size()));
+  mChanged.assign(mNodes.size(), 0);
+}
+
+void HierarchySystem::propagate(size_t begin, size_t end, bool all) {
+  for (size_t i{begin}; i < end; ++i) {
+    Node &node = mNodes[i];
+    // the version also moves when another system rebuilt the matrix of a child
+    bool changed = all || node.world->version != node.version;
+
+    if (node.parent != NO_PARENT) {
+      changed = changed || mChanged[node.parent] || node.local->dirty;
+      if (changed) {
+        const WorldMatrix &parent = *mNodes[node.parent].world;
+        node.world->model = parent.model * node.local->mat4();
+        node.world->normal = parent.normal * glm::mat4{node.local->normalMatrix()};
+        ++node.world->version;
+        node.local->dirty = false;
+        node.transform->mirrorWorldPosition(glm::vec3{node.world->model[3]});
+      }
+    }
+
+    node.version = node.world->version;
+    mChanged[i] = changed;
+  }
+}
+
+} // namespace ecs
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../Base/centralizer.hpp"
+#include "../Base/system.hpp"
+
+#include "../Components/hierarchy.hpp"
+#include "../Components/local_transform.hpp"
+#include "../Components/transform.hpp"
+#include "../Components/world_matrix.hpp"
+
+// std
+#include <cstdint>
+#include <vector>
+
+namespace ecs {
+
+// Propagates world matrices down Parent / Children hierarchies.
+// Every root (Children without Parent) and its descendants are laid out breadth first in one
+// packed array, rebuilt only when the structure of the world changed. Subtrees are
+// propagated in parallel, a node is only recomputed when its parent or its LocalTransform
+// changed. Runs after the TransformSystem, which keeps handling the roots.
+class HierarchySystem : public System {
+public:
+  explicit HierarchySystem(Centralizer &centralizer);
+
+  // Make `child` follow `parent`, detaching it from its previous parent.
+  // Both need a WorldMatrix, the child a LocalTransform and a Transform.
+  static void attach(Centralizer &centralizer, Entity child, Entity parent);
+  // The child keeps its last world matrix and becomes a root
+  static void detach(Centralizer &centralizer, Entity child);
+  // Destroying an entity drops it from its parent's Children and turns its children into
+  // roots, when the Centralizer dispatches its events.
+
+  void update();
+
+private:
+  static constexpr std::uint32_t NO_PARENT = UINT32_MAX;
+  // root subtrees propagated per job
+  static constexpr size_t SUBTREES_PER_JOB = 8;
+
+  // Component pointers are valid until the structure version changes
+  struct Node {
+    std::uint32_t parent;
+    WorldMatrix *world;
+    LocalTransform *local;
+    Transform *transform;
+    // WorldMatrix::version seen by the last propagation
+    std::uint32_t version;
+  };
+
+  void unlinkDestroyed(const std::vector<Entity> &entities);
+  // Alive and owning the components of a child node
+  bool isNode(Entity child);
+  void rebuild();
+  void propagate(size_t begin, size_t end, bool all);
+
+  Centralizer &mCentralizer;
+  std::vector<Node> mNodes{};
+  // first node of each root subtree, followed by mNodes.size()
+  std::vector<std::uint32_t> mSubtrees{};
+  // per node, set when its world matrix moved during the last propagation
+  std::vector<std::uint8_t> mChanged{};
+  std::uint64_t mStructureVersion{UINT64_MAX};
+};
+} // namespace ecs
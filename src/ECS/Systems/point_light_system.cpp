@@ -1,5 +1,7 @@
 #include "point_light_system.hpp"
 
+#include "../../profiler/profiler.hpp"
+
 // libs
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -12,15 +14,16 @@
 #include <map>
 #include <stdexcept>
 
-extern std::unique_ptr<ecs::Centralizer> gCentralizer;
-
 namespace ecs {
 
-PointLightSystem::PointLightSystem(Device &device, VkRenderPass renderPass,
-                                   VkDescriptorSetLayout globalSetLayout)
-    : IRenderSystem(device, renderPass, globalSetLayout) {
+PointLightSystem::PointLightSystem(Centralizer &centralizer, Device &device,
+                                   VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout)
+    : IRenderSystem(centralizer, device, renderPass, globalSetLayout) {
   mPushConstantRangeSize = sizeof(PointLightPushConstants);
   initPipeline(renderPass, globalSetLayout);
+
+  mReads = componentSignature<ecs::PointLight, ecs::Color, ecs::Transform>();
+  mWrites = componentSignature<ecs::LocalTransform>();
 }
 
 void PointLightSystem::createPipeline(VkRenderPass renderPass) {
@@ -37,31 +40,40 @@ void PointLightSystem::createPipeline(VkRenderPass renderPass) {
                                            "shaders/point_light.frag.spv", pipelineConfig);
 }
 
-void PointLightSystem::update(FrameInfo &frameInfo, GlobalUbo &ubo) {
+void PointLightSystem::orbit(FrameInfo &frameInfo) {
+  PROFILE_ZONE("PointLightSystem::orbit");
+  auto rotateLight = glm::rotate(glm::mat4(1.f), 0.5f * frameInfo.frameTime, {0.f, -1.f, 0.f});
 
-  assert(mEntities.size() <= MAX_LIGHTS && "Point lights exceed maximum specified");
+  mCentralizer.view<ecs::PointLight, ecs::LocalTransform>().each(
+      [&](Entity e, ecs::PointLight &, ecs::LocalTransform &local) {
+        local.setPosition(glm::vec3(rotateLight * glm::vec4(local.position(), 1.f)));
+      });
+}
 
-  auto rotateLight = glm::rotate(glm::mat4(1.f), 0.5f * frameInfo.frameTime, {0.f, -1.f, 0.f});
+void PointLightSystem::update(FrameInfo &frameInfo, GlobalUbo &ubo) {
+  PROFILE_ZONE("PointLightSystem::update");
 
   size_t lightIndex = 0;
-  for (const Entity &e : mEntities) {
-    auto &pointLight = gCentralizer->getComponent<ecs::PointLight>(e);
-    auto &color = gCentralizer->getComponent<ecs::Color>(e);
-    auto &transform = gCentralizer->getComponent<ecs::Transform>(e);
-
-    // update light position
-    transform.position = glm::vec3(rotateLight * glm::vec4(transform.position, 1.f));
-
-    // copy light to ubo
-    ubo.pointLights[lightIndex].position = glm::vec4(transform.position, 1.f);
-    ubo.pointLights[lightIndex].color = glm::vec4(color.color, pointLight.lightIntensity);
-    ++lightIndex;
-  }
-  ubo.numLights = mEntities.size();
+  size_t lightCount = 0;
+  mCentralizer.view<ecs::PointLight, ecs::Color, ecs::Transform>().each(
+      [&](Entity e, ecs::PointLight &pointLight, ecs::Color &color, ecs::Transform &transform) {
+        ++lightCount;
+        // lights past the ubo capacity are left out
+        if (lightIndex == MAX_LIGHTS) {
+          return;
+        }
+        // copy light to ubo
+        ubo.pointLights[lightIndex].position = glm::vec4(transform.position(), 1.f);
+        ubo.pointLights[lightIndex].color = glm::vec4(color.color, pointLight.lightIntensity);
+        ++lightIndex;
+      });
+  assert(lightCount <= MAX_LIGHTS && "Point lights exceed maximum specified");
+  ubo.numLights = lightIndex;
 }
 
 void PointLightSystem::render(FrameInfo &frameInfo) {
-  std::map<float, ecs::Entity> sorted = getSortedEntities(mEntities, true);
+  PROFILE_ZONE("PointLightSystem::render");
+  auto sorted = getSortedEntities<ecs::Transform, ecs::Color, ecs::PointLight>(true);
 
   mVuPipeline->bind(frameInfo.commandBuffer);
 
@@ -69,15 +81,12 @@ void PointLightSystem::render(FrameInfo &frameInfo) {
                           0, 1, &frameInfo.globalDescriptorSet, 0, nullptr);
 
   for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
-    // use game obj id to find light object
-    auto &transform = gCentralizer->getComponent<ecs::Transform>(it->second);
-    auto &color = gCentralizer->getComponent<ecs::Color>(it->second);
-    auto &pointLight = gCentralizer->getComponent<ecs::PointLight>(it->second);
+    auto &[transform, color, pointLight] = it->second;
 
     PointLightPushConstants push{};
-    push.position = glm::vec4(transform.position, 1.f);
+    push.position = glm::vec4(transform.position(), 1.f);
     push.color = glm::vec4(color.color, pointLight.lightIntensity);
-    push.radius = transform.scale.x;
+    push.radius = transform.scale().x;
 
     vkCmdPushConstants(frameInfo.commandBuffer, mPipelineLayout,
                        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
@@ -8,6 +8,7 @@
 
 #include "../Components/camera.hpp"
 #include "../Components/color.hpp"
+#include "../Components/local_transform.hpp"
 #include "../Components/point_light.hpp"
 #include "../Components/transform.hpp"
 
@@ -28,9 +29,13 @@ struct PointLightPushConstants {
 namespace ecs {
 class PointLightSystem : public IRenderSystem {
 public:
-  PointLightSystem(Device &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout);
+  PointLightSystem(Centralizer &centralizer, Device &device, VkRenderPass renderPass,
+                   VkDescriptorSetLayout globalSetLayout);
 
   void render(FrameInfo &frameInfo) override;
+  // Turn the lights around their parent
+  void orbit(FrameInfo &frameInfo);
+  // Copy the lights to the ubo, their world position is only final after the HierarchySystem
   void update(FrameInfo &frameInfo, GlobalUbo &ubo) override;
 
 protected:
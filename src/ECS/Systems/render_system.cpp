@@ -1,12 +1,10 @@
 #include "render_system.hpp"
 
-extern std::unique_ptr<ecs::Centralizer> gCentralizer;
-
 namespace ecs {
 
-IRenderSystem::IRenderSystem(Device &device, VkRenderPass renderPass,
+IRenderSystem::IRenderSystem(Centralizer &centralizer, Device &device, VkRenderPass renderPass,
                              VkDescriptorSetLayout globalSetLayout)
-    : mVuDevice{device} {}
+    : mCentralizer{centralizer}, mVuDevice{device} {}
 
 IRenderSystem::~IRenderSystem() {
   vkDestroyPipelineLayout(mVuDevice.device(), mPipelineLayout, nullptr);
@@ -37,37 +35,31 @@ void IRenderSystem::createPipelineLayout(VkDescriptorSetLayout globalSetLayout)
   }
 }
 
-std::map<float, ecs::Entity> const
-IRenderSystem::getSortedEntities(const std::set<Entity> &entities, bool withY) {
-  std::map<float, ecs::Entity> sorted;
-
+glm::vec3 IRenderSystem::getSortOrigin(bool withY) {
   // Récupérer la caméra à partir du centralizer
-  auto &cam = gCentralizer->getComponent<ecs::Camera>(CAMERA_ENTITY);
+  auto &cam = mCentralizer.getComponent<ecs::Camera>(CAMERA_ENTITY);
   glm::vec3 camPos = cam.getPosition();
   if (!withY)
     camPos.y = 0.0f;
+  return camPos;
+}
 
-  for (const Entity &e : entities) {
-    auto &transform = gCentralizer->getComponent<ecs::Transform>(e);
-    auto &color = gCentralizer->getComponent<ecs::Color>(e);
-    // glm::vec3 cameraToObject = transform.position - camera.getPosition();
-    glm::vec3 elementPos = transform.position;
-    if (!withY)
-      elementPos.y = 0.0f;
-    float distance = 1.f;
-    // if (glm::dot(cameraToObject, viewDirection) > 0) {
-    if (color.color != glm::vec3{1.f}) {
-      distance =
-          0.5 * glm::length(camPos - elementPos) * glm::length(camPos - elementPos) / 80.f + 0.1f;
-    } else {
-      distance = 1.f;
-    }
-    sorted.emplace(distance + transform.position.y * 0.0001f,
-                   e); // transform.position.y * 0.0001f to ensure unicity on map
-    //}
+float IRenderSystem::getSortKey(const glm::vec3 &camPos, const ecs::Transform &transform,
+                                const ecs::Color &color, bool withY) {
+  // glm::vec3 cameraToObject = transform.position - camera.getPosition();
+  glm::vec3 elementPos = transform.position();
+  if (!withY)
+    elementPos.y = 0.0f;
+  float distance = 1.f;
+  // if (glm::dot(cameraToObject, viewDirection) > 0) {
+  if (color.color != glm::vec3{1.f}) {
+    distance =
+        0.5 * glm::length(camPos - elementPos) * glm::length(camPos - elementPos) / 80.f + 0.1f;
+  } else {
+    distance = 1.f;
   }
-
-  return sorted;
+  return distance + transform.position().y * 0.0001f; // transform.position.y * 0.0001f to ensure
+                                                    // unicity on map
 }
 
 void IRenderSystem::createPipeline(VkRenderPass renderPass) {}
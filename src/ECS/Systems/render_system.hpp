@@ -16,6 +16,8 @@
 // std
 #include <map>
 #include <memory>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 using namespace vu;
@@ -25,7 +27,8 @@ namespace ecs {
 // Classe de base pour les systèmes de rendu
 class IRenderSystem : public System {
 public:
-  IRenderSystem(Device &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout);
+  IRenderSystem(Centralizer &centralizer, Device &device, VkRenderPass renderPass,
+                VkDescriptorSetLayout globalSetLayout);
   ~IRenderSystem();
 
   IRenderSystem(const IRenderSystem &) = delete;
@@ -39,9 +42,50 @@ protected:
   void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
   virtual void createPipeline(VkRenderPass renderPass);
   void initPipeline(VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout);
-  static const std::map<float, ecs::Entity> getSortedEntities(const std::set<Entity> &entities,
-                                                              bool withY);
 
+  // Components of every entity owning all the Ts, sorted by distance to the camera.
+  // Transform and Color have to be part of the Ts.
+  template <typename... Ts> std::map<float, std::tuple<Ts &...>> getSortedEntities(bool withY) {
+    return getSortedEntities<Ts...>(mCentralizer.view<Ts...>(), withY);
+  }
+
+  // Same over the entities of a View or a Group of the Ts
+  template <typename... Ts, typename Range>
+  std::map<float, std::tuple<Ts &...>> getSortedEntities(const Range &view, bool withY) {
+    using Entry = std::pair<float, std::tuple<Ts &...>>;
+
+    const glm::vec3 camPos = getSortOrigin(withY);
+
+    // keys are computed in parallel, each chunk keeps its entries in view order
+    const size_t count = view.sizeHint();
+    std::vector<std::vector<Entry>> chunks((count + SORT_CHUNK_SIZE - 1) / SORT_CHUNK_SIZE);
+    mCentralizer.getJobSystem().parallelFor(count, SORT_CHUNK_SIZE, [&](size_t begin, size_t end) {
+      std::vector<Entry> &entries = chunks[begin / SORT_CHUNK_SIZE];
+      view.eachInRange(begin, end, [&](Entity e, Ts &...components) {
+        std::tuple<Ts &...> entry{components...};
+        const float key = getSortKey(camPos, std::get<ecs::Transform &>(entry),
+                                     std::get<ecs::Color &>(entry), withY);
+        entries.emplace_back(key, entry);
+      });
+    });
+
+    // inserted in view order, the first entity keeps a duplicated key
+    std::map<float, std::tuple<Ts &...>> sorted;
+    for (std::vector<Entry> &entries : chunks) {
+      for (Entry &entry : entries) {
+        sorted.emplace(entry.first, entry.second);
+      }
+    }
+    return sorted;
+  }
+  glm::vec3 getSortOrigin(bool withY);
+  static float getSortKey(const glm::vec3 &camPos, const ecs::Transform &transform,
+                          const ecs::Color &color, bool withY);
+
+  // entities whose sort key is computed per job
+  static constexpr size_t SORT_CHUNK_SIZE = 256;
+
+  Centralizer &mCentralizer;
   Device &mVuDevice;
   std::unique_ptr<Pipeline> mVuPipeline;
   VkPipelineLayout mPipelineLayout;
@@ -1,14 +1,17 @@
 #include "shadow_map_system.hpp"
 
-extern std::unique_ptr<ecs::Centralizer> gCentralizer;
+#include "../../profiler/profiler.hpp"
 
 namespace ecs {
 
-ShadowMapSystem::ShadowMapSystem(Device &device, VkRenderPass renderPass,
-                                 VkDescriptorSetLayout globalSetLayout)
-    : IRenderSystem(device, renderPass, globalSetLayout) {
+ShadowMapSystem::ShadowMapSystem(Centralizer &centralizer, Device &device, MeshRegistry &meshes,
+                                 VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout)
+    : IRenderSystem(centralizer, device, renderPass, globalSetLayout), mMeshes{meshes} {
   mPushConstantRangeSize = sizeof(SimplePushConstantData);
   initPipeline(renderPass, globalSetLayout);
+
+  mReads = componentSignature<ecs::Transform, ecs::Model, ecs::Color, ecs::WorldMatrix,
+                              ecs::Camera>();
 }
 
 void ShadowMapSystem::createPipeline(VkRenderPass renderPass) {
@@ -24,31 +27,34 @@ void ShadowMapSystem::createPipeline(VkRenderPass renderPass) {
 }
 
 void ShadowMapSystem::render(FrameInfo &frameInfo) {
+  PROFILE_ZONE("ShadowMapSystem::render");
   mVuPipeline->bind(frameInfo.commandBuffer);
 
   vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout,
                           0, 1, &frameInfo.globalDescriptorSet, 0, nullptr);
 
-  std::map<float, ecs::Entity> sorted = getSortedEntities(mEntities, false);
+  auto sorted = getSortedEntities<ecs::Transform, ecs::Model, ecs::Color, ecs::WorldMatrix>(
+      mCentralizer.group<ecs::Transform, ecs::Model, ecs::Color, ecs::WorldMatrix>(), false);
 
-  auto &cam = gCentralizer->getComponent<ecs::Camera>(LIGHT_CAMERA_ENTITY);
-  glm::vec3 camPos = cam.getPosition();
-  camPos.y = 0.0f;
+  // consecutive entities drawing the same mesh keep its buffers bound
+  MeshHandle boundMesh = INVALID_MESH;
   for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
-    auto &transform = gCentralizer->getComponent<ecs::Transform>(it->second);
-    auto &model = gCentralizer->getComponent<ecs::Model>(it->second);
-    auto &color = gCentralizer->getComponent<ecs::Color>(it->second);
+    auto &[transform, model, color, worldMatrix] = it->second;
 
-    if (model.model == nullptr)
+    if (model.mesh == INVALID_MESH)
       continue;
     SimplePushConstantData push{};
-    push.modelMatrix = transform.mat4();
+    push.modelMatrix = worldMatrix.model;
 
     vkCmdPushConstants(frameInfo.commandBuffer, mPipelineLayout,
                        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
                        sizeof(SimplePushConstantData), &push);
-    model.model->bind(frameInfo.commandBuffer);
-    model.model->draw(frameInfo.commandBuffer);
+    vu::Model &mesh = mMeshes.get(model.mesh);
+    if (model.mesh != boundMesh) {
+      mesh.bind(frameInfo.commandBuffer);
+      boundMesh = model.mesh;
+    }
+    mesh.draw(frameInfo.commandBuffer);
   }
 }
 
@@ -1,5 +1,7 @@
 #include "simple_render_system.hpp"
 
+#include "../../profiler/profiler.hpp"
+
 // libs
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -11,15 +13,17 @@
 #include <cassert>
 #include <stdexcept>
 
-extern std::unique_ptr<ecs::Centralizer> gCentralizer;
-
 namespace ecs {
 
-SimpleRenderSystem::SimpleRenderSystem(Device &device, VkRenderPass renderPass,
+SimpleRenderSystem::SimpleRenderSystem(Centralizer &centralizer, Device &device,
+                                       MeshRegistry &meshes, VkRenderPass renderPass,
                                        VkDescriptorSetLayout globalSetLayout)
-    : IRenderSystem(device, renderPass, globalSetLayout) {
+    : IRenderSystem(centralizer, device, renderPass, globalSetLayout), mMeshes{meshes} {
   mPushConstantRangeSize = sizeof(SimplePushConstantData);
   initPipeline(renderPass, globalSetLayout);
+
+  mReads = componentSignature<ecs::Transform, ecs::Model, ecs::Color, ecs::WorldMatrix,
+                              ecs::Camera>();
 }
 
 void SimpleRenderSystem::createPipeline(VkRenderPass renderPass) {
@@ -35,34 +39,38 @@ void SimpleRenderSystem::createPipeline(VkRenderPass renderPass) {
 }
 
 void SimpleRenderSystem::render(FrameInfo &frameInfo) {
+  PROFILE_ZONE("SimpleRenderSystem::render");
   mVuPipeline->bind(frameInfo.commandBuffer);
 
   vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout,
                           0, 1, &frameInfo.globalDescriptorSet, 0, nullptr);
 
-  std::map<float, ecs::Entity> sorted = getSortedEntities(mEntities, false);
+  // the group keeps the four pools aligned, the keys are computed over linear scans
+  auto sorted = getSortedEntities<ecs::Transform, ecs::Model, ecs::Color, ecs::WorldMatrix>(
+      mCentralizer.group<ecs::Transform, ecs::Model, ecs::Color, ecs::WorldMatrix>(), false);
 
-  auto &cam = gCentralizer->getComponent<ecs::Camera>(CAMERA_ENTITY);
-  glm::vec3 camPos = cam.getPosition();
-  camPos.y = 0.0f;
+  // consecutive entities drawing the same mesh keep its buffers bound
+  MeshHandle boundMesh = INVALID_MESH;
   for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
-    auto &transform = gCentralizer->getComponent<ecs::Transform>(it->second);
-    auto &model = gCentralizer->getComponent<ecs::Model>(it->second);
-    auto &color = gCentralizer->getComponent<ecs::Color>(it->second);
+    auto &[transform, model, color, worldMatrix] = it->second;
 
-    if (model.model == nullptr)
+    if (model.mesh == INVALID_MESH)
       continue;
     SimplePushConstantData push{};
-    push.modelMatrix = transform.mat4();
-    push.normalMatrix = transform.normalMatrix();
+    push.modelMatrix = worldMatrix.model;
+    push.normalMatrix = worldMatrix.normal;
     push.color = color.color;
     push.dist = it->first;
 
     vkCmdPushConstants(frameInfo.commandBuffer, mPipelineLayout,
                        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
                        sizeof(SimplePushConstantData), &push);
-    model.model->bind(frameInfo.commandBuffer);
-    model.model->draw(frameInfo.commandBuffer);
+    vu::Model &mesh = mMeshes.get(model.mesh);
+    if (model.mesh != boundMesh) {
+      mesh.bind(frameInfo.commandBuffer);
+      boundMesh = model.mesh;
+    }
+    mesh.draw(frameInfo.commandBuffer);
   }
 }
 
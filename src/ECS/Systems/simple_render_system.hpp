@@ -1,6 +1,6 @@
 #pragma once
 
-#include "../../vulkan/model.hpp"
+#include "../../vulkan/mesh_registry.hpp"
 #include "../../vulkan/uniform_buffer_type.hpp"
 
 #include "../Base/centralizer.hpp"
@@ -10,6 +10,7 @@
 #include "../Components/color.hpp"
 #include "../Components/model.hpp"
 #include "../Components/transform.hpp"
+#include "../Components/world_matrix.hpp"
 
 #include "render_system.hpp"
 
@@ -30,13 +31,15 @@ struct SimplePushConstantData {
 namespace ecs {
 class SimpleRenderSystem : public IRenderSystem {
 public:
-  SimpleRenderSystem(Device &device, VkRenderPass renderPass,
-                     VkDescriptorSetLayout globalSetLayout);
+  SimpleRenderSystem(Centralizer &centralizer, Device &device, MeshRegistry &meshes,
+                     VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout);
   void render(FrameInfo &frameInfo) override;
   void update(FrameInfo &frameInfo, GlobalUbo &ubo) override;
 
 protected:
   void createPipelineConfigInfo(PipelineConfigInfo &configInfo);
   void createPipeline(VkRenderPass renderPass) override;
+
+  MeshRegistry &mMeshes;
 };
 } // namespace ecs
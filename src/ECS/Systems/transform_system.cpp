@@ -0,0 +1,76 @@
+#include "transform_system.hpp"
+
+#include "../../profiler/profiler.hpp"
+
+namespace ecs {
+
+namespace {
+void rebuild(ecs::Transform &transform, ecs::WorldMatrix &worldMatrix) {
+  worldMatrix.model = transform.mat4();
+  worldMatrix.normal = transform.normalMatrix();
+  ++worldMatrix.version;
+  transform.dirty = false;
+}
+
+bool moved(const ecs::Transform &previous, const ecs::Transform &transform) {
+  return previous.position() != transform.position() ||
+         previous.rotation() != transform.rotation() || previous.scale() != transform.scale();
+}
+} // namespace
+
+TransformSystem::TransformSystem(Centralizer &centralizer) : mCentralizer{centralizer} {
+  // clearing the dirty flag writes the Transform
+  mWrites = componentSignature<ecs::Transform, ecs::WorldMatrix, ecs::PreviousTransform>();
+
+  // a WorldMatrix added to an entity whose Transform was already clean
+  mCentralizer.onAdd<ecs::WorldMatrix>([this](const std::vector<Entity> &entities) {
+    for (Entity e : entities) {
+      if (mCentralizer.hasComponent<ecs::Transform>(e)) {
+        rebuild(mCentralizer.getComponent<ecs::Transform>(e),
+                mCentralizer.getComponent<ecs::WorldMatrix>(e));
+      }
+    }
+  });
+}
+
+void TransformSystem::update(float alpha) {
+  PROFILE_ZONE("TransformSystem::update");
+  // first so the pass below finds them clean
+  mCentralizer.getJobSystem().parallelFor(
+      mCentralizer.view<ecs::PreviousTransform, ecs::Transform, ecs::WorldMatrix>(), CHUNK_SIZE,
+      [&](Entity e, ecs::PreviousTransform &previous, ecs::Transform &transform,
+          ecs::WorldMatrix &worldMatrix) {
+        if (moved(previous, transform)) {
+          ecs::Transform interpolated{glm::mix(previous.position(), transform.position(), alpha),
+                                      glm::mix(previous.rotation(), transform.rotation(), alpha),
+                                      glm::mix(previous.scale(), transform.scale(), alpha)};
+          rebuild(interpolated, worldMatrix);
+          transform.dirty = false;
+        } else if (transform.dirty) {
+          rebuild(transform, worldMatrix);
+        }
+      });
+
+  mCentralizer.getJobSystem().parallelFor(
+      mCentralizer.view<ecs::Transform, ecs::WorldMatrix>(), CHUNK_SIZE,
+      [&](Entity e, ecs::Transform &transform, ecs::WorldMatrix &worldMatrix) {
+        if (transform.dirty) {
+          rebuild(transform, worldMatrix);
+        }
+      });
+}
+
+void TransformSystem::savePrevious() {
+  PROFILE_ZONE("TransformSystem::savePrevious");
+  mCentralizer.getJobSystem().parallelFor(
+      mCentralizer.view<ecs::Transform, ecs::PreviousTransform>(), CHUNK_SIZE,
+      [](Entity e, ecs::Transform &transform, ecs::PreviousTransform &previous) {
+        // dirty so an entity coming to rest still gets its final WorldMatrix
+        if (moved(previous, transform)) {
+          static_cast<ecs::Transform &>(previous) = transform;
+          transform.dirty = true;
+        }
+      });
+}
+
+} // namespace ecs
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "../Base/centralizer.hpp"
+#include "../Base/system.hpp"
+
+#include "../Components/previous_transform.hpp"
+#include "../Components/transform.hpp"
+#include "../Components/world_matrix.hpp"
+
+namespace ecs {
+// Rebuilds the WorldMatrix of every dirty Transform, untouched entities cost a flag test.
+// New WorldMatrix components are built when the Centralizer dispatches its events.
+// Entities with a PreviousTransform are moved by the fixed step simulation, their
+// WorldMatrix is built between the PreviousTransform and the Transform.
+class TransformSystem : public System {
+public:
+  // WorldMatrix has to be registered already
+  explicit TransformSystem(Centralizer &centralizer);
+
+  // alpha in [0, 1] from the PreviousTransform to the Transform, see FixedTimestep
+  void update(float alpha = 1.f);
+
+  // Before each simulation step, Transform to PreviousTransform
+  void savePrevious();
+
+private:
+  Centralizer &mCentralizer;
+
+  // entities checked per job
+  static constexpr size_t CHUNK_SIZE = 1024;
+};
+} // namespace ecs
@@ -1,19 +1,57 @@
 #pragma once
 
 #include <bitset>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 
 namespace ecs {
 
+// Entity handle: slot index in the low bits, generation of the slot in the high bits.
+// The generation is bumped every time the slot is freed, a stale handle never
+// matches the entity recycled in its slot.
 using Entity = std::uint32_t;
 using ComponentType = std::uint8_t;
 
-constexpr Entity MAX_ENTITIES = 5000;
+constexpr Entity ENTITY_INDEX_BITS = 22;
+constexpr Entity ENTITY_INDEX_MASK = (Entity{1} << ENTITY_INDEX_BITS) - 1;
+constexpr Entity ENTITY_GENERATION_MASK = std::numeric_limits<Entity>::max() >> ENTITY_INDEX_BITS;
+
+constexpr Entity entityIndex(Entity entity) { return entity & ENTITY_INDEX_MASK; }
+constexpr Entity entityGeneration(Entity entity) { return entity >> ENTITY_INDEX_BITS; }
+constexpr Entity makeEntity(Entity index, Entity generation) {
+  return (generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS | index;
+}
+
+// Upper bound only, storage grows with the world. The last index is never handed
+// out so INVALID_ENTITY can't be a living entity.
+constexpr Entity MAX_ENTITIES = ENTITY_INDEX_MASK;
 constexpr ComponentType MAX_COMPONENTS = 32;
 
+constexpr Entity INVALID_ENTITY = std::numeric_limits<Entity>::max();
+
 constexpr Entity CAMERA_ENTITY = 0;
 constexpr Entity LIGHT_CAMERA_ENTITY = 1;
 
 using Signature = std::bitset<MAX_COMPONENTS>;
 
+// World time for change detection, advanced once per frame by the application.
+// Starts at 1 so a tick of 0 means "since forever".
+using Tick = std::uint32_t;
+
+// When a component was added to its entity and last written through the Centralizer.
+// Writes through a plain reference from getComponent() or a view leave them untouched.
+// Read by View::changedSince / addedSince, the SoA GravitySystem reloads its bodies with it.
+struct ComponentTicks {
+  Tick added{0};
+  Tick changed{0};
+};
+
+// Memory held by one storage pool, a component array (single bit signature) or an archetype
+struct PoolMemoryUsage {
+  Signature signature;
+  size_t count;
+  size_t bytes;
+};
+
 } // namespace ecs
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ecs_type.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace ecs {
+
+// Sequential index per type, handed out on first use and cached in a static.
+// Each Family counts on its own, so components and systems both start at 0.
+// No RTTI involved.
+template <typename Family> class TypeId {
+public:
+  template <typename T> static std::size_t get() {
+    static const std::size_t id = mCounter.fetch_add(1, std::memory_order_relaxed);
+    return id;
+  }
+
+private:
+  static inline std::atomic<std::size_t> mCounter{0};
+};
+
+struct ComponentFamily;
+struct SystemFamily;
+
+template <typename T> std::size_t componentTypeId() { return TypeId<ComponentFamily>::get<T>(); }
+template <typename T> std::size_t systemTypeId() { return TypeId<SystemFamily>::get<T>(); }
+
+// Signature with the bit of every Ts set, usable before the components are registered
+template <typename... Ts> Signature componentSignature() {
+  Signature signature;
+  (signature.set(componentTypeId<Ts>()), ...);
+  return signature;
+}
+
+} // namespace ecs
@@ -1,11 +1,17 @@
 #include "app.hpp"
 
+#include "ECS/Base/fixed_timestep.hpp"
+#include "ECS/Base/scheduler.hpp"
 #include "ECS/Systems/camera_input_system.hpp"
 #include "ECS/Systems/camera_system.hpp"
-#include "ECS/Systems/collision_system.hpp"
+#include "ECS/Systems/gravity_kernel.hpp"
 #include "ECS/Systems/gravity_system.hpp"
+#include "ECS/Systems/hierarchy_system.hpp"
 #include "ECS/Systems/point_light_system.hpp"
 #include "ECS/Systems/simple_render_system.hpp"
+#include "ECS/Systems/transform_system.hpp"
+#include "profiler/profiler.hpp"
+#include "scene.hpp"
 #include "vulkan/buffer.hpp"
 #include "vulkan/shadow_map.hpp"
 
@@ -19,154 +25,62 @@
 #include <array>
 #include <cassert>
 #include <chrono>
-#include <random>
+#include <iostream>
 #include <stdexcept>
 
-extern std::unique_ptr<ecs::Centralizer> gCentralizer;
-
 namespace vu {
 
-App::App() {}
+App::App(AppSettings settings)
+    : mSettings{settings}, mCentralizer{std::make_unique<ecs::Centralizer>(settings.backend)} {}
 
 App::~App() {}
 
 void App::registerComponents() {
-  gCentralizer->registerComponent<ecs::Model>();
-  gCentralizer->registerComponent<ecs::Transform>();
-  gCentralizer->registerComponent<ecs::Color>();
-  gCentralizer->registerComponent<ecs::PointLight>();
-  gCentralizer->registerComponent<ecs::Camera>();
-  gCentralizer->registerComponent<ecs::Gravity>();
-  gCentralizer->registerComponent<ecs::RigidBody>();
+  mCentralizer->registerComponent<ecs::Model>();
+  registerSceneComponents(*mCentralizer);
 }
 
 void App::setSignatures() {
   ecs::Signature simpleRenderSystemSignature;
-  simpleRenderSystemSignature.set(gCentralizer->getComponentType<ecs::Model>());
-  simpleRenderSystemSignature.set(gCentralizer->getComponentType<ecs::Transform>());
-  gCentralizer->setSystemSignature<ecs::SimpleRenderSystem>(simpleRenderSystemSignature);
+  simpleRenderSystemSignature.set(mCentralizer->getComponentType<ecs::Model>());
+  simpleRenderSystemSignature.set(mCentralizer->getComponentType<ecs::Transform>());
+  simpleRenderSystemSignature.set(mCentralizer->getComponentType<ecs::WorldMatrix>());
+  mCentralizer->setSystemSignature<ecs::SimpleRenderSystem>(simpleRenderSystemSignature);
 
   ecs::Signature pointLightSystemSignature;
-  pointLightSystemSignature.set(gCentralizer->getComponentType<ecs::Transform>());
-  pointLightSystemSignature.set(gCentralizer->getComponentType<ecs::Color>());
-  pointLightSystemSignature.set(gCentralizer->getComponentType<ecs::PointLight>());
-  gCentralizer->setSystemSignature<ecs::PointLightSystem>(pointLightSystemSignature);
-
-  ecs::Signature cameraSignature;
-  cameraSignature.set(gCentralizer->getComponentType<ecs::Camera>());
-  cameraSignature.set(gCentralizer->getComponentType<ecs::Transform>());
-  gCentralizer->setSystemSignature<ecs::CameraSystem>(cameraSignature);
-  gCentralizer->setSystemSignature<ecs::CameraInputSystem>(cameraSignature);
-
-  ecs::Signature gravitySignature;
-  gravitySignature.set(gCentralizer->getComponentType<ecs::Transform>());
-  gravitySignature.set(gCentralizer->getComponentType<ecs::Gravity>());
-  gravitySignature.set(gCentralizer->getComponentType<ecs::RigidBody>());
-  gCentralizer->setSystemSignature<ecs::GravitySystem>(gravitySignature);
+  pointLightSystemSignature.set(mCentralizer->getComponentType<ecs::Transform>());
+  pointLightSystemSignature.set(mCentralizer->getComponentType<ecs::Color>());
+  pointLightSystemSignature.set(mCentralizer->getComponentType<ecs::PointLight>());
+  mCentralizer->setSystemSignature<ecs::PointLightSystem>(pointLightSystemSignature);
+
+  setSimulationSignatures(*mCentralizer);
 }
 
 void App::createEntities() {
-  // Camera
-  {
-    ecs::Entity e = gCentralizer->createEntity();
-    gCentralizer->addComponent(e, ecs::Camera{});
-    gCentralizer->addComponent(e, ecs::Transform{{1.f, 1.f, 1.5f}, {}, {}});
-    // gCentralizer->addComponent(e, ecs::Gravity{{0.f, ecs::GRAVITY_CONSTANT, 0.f}});
-    // gCentralizer->addComponent(e, ecs::RigidBody{{}, {}, 1.f});
-
-    e = gCentralizer->createEntity();
-    gCentralizer->addComponent(e, ecs::Camera{});
-    gCentralizer->addComponent(e, ecs::Transform{{0.f, 200.f, -2.5f}, {}, {}});
-  }
-
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  // Object
-  {
-    std::uniform_real_distribution<float> col(0.0f, 1.0f);
-    std::uniform_real_distribution<float> dis(4.0f, 16.0f);
-    std::uniform_real_distribution<float> dis2(.5f, .05f);
-    std::uniform_real_distribution<float> dis3(-5.f, 5.f);
-
-    std::shared_ptr<Model> treeModel = Model::createModelFromFile(mVuDevice, "models/Tree.obj");
-    std::shared_ptr<Model> cubeModel = Model::createModelFromFile(mVuDevice, "models/cube.obj");
-
-    for (size_t i{0}; i < 5; ++i) {
-      for (size_t j{0}; j < 5; ++j) {
-        float h = col(gen) * 5;
-        float xOff = (col(gen) - 0.5) * 5.f;
-        float zOff = (col(gen) - 0.5) * 5.f;
-        ecs::Entity treeEntity = gCentralizer->createEntity();
-        gCentralizer->addComponent(
-            treeEntity,
-            ecs::Transform{{i * 10 + xOff, 0.4f + h, j * 10 + zOff},
-                           {col(gen) * glm::radians(10.f), col(gen) * glm::radians(360.f), 0.f},
-                           {3.f, 3.f, 3.f}});
-
-        gCentralizer->addComponent(treeEntity, ecs::Model{treeModel});
-        gCentralizer->addComponent(treeEntity, ecs::Color{{col(gen), col(gen), col(gen)}});
-
-        ecs::Entity cubeEntity = gCentralizer->createEntity();
-        gCentralizer->addComponent(cubeEntity, ecs::Model{cubeModel});
-        gCentralizer->addComponent(cubeEntity,
-                                   ecs::Transform{{i * 10 + xOff, -.5f + h, j * 10 + zOff},
-                                                  {0.f, 0.f, 0.f},
-                                                  {1.f, 1.f, 1.f}});
-        gCentralizer->addComponent(cubeEntity, ecs::Color{{col(gen), col(gen), col(gen)}});
-      }
-    }
-
-    for (size_t i{0}; i < 10; ++i) {
-      for (size_t j{0}; j < 10; ++j) {
-        ecs::Entity cube = gCentralizer->createEntity();
-        gCentralizer->addComponent(cube, ecs::Model{cubeModel});
-
-        gCentralizer->addComponent(
-            cube, ecs::Transform{{i * 10, 30, j * 10},
-                                 {col(gen) * glm::radians(360.f), col(gen) * glm::radians(360.f),
-                                  col(gen) * glm::radians(360.f)},
-                                 {col(gen), col(gen), col(gen)}});
-        gCentralizer->addComponent(cube, ecs::Color{{col(gen), col(gen), col(gen)}});
-
-        gCentralizer->addComponent(cube, ecs::Gravity{{0.f, ecs::GRAVITY_CONSTANT, 0.f}});
-        gCentralizer->addComponent(cube, ecs::RigidBody{{}, {}, dis(gen) / 10.f});
-      }
-    }
-
-    ecs::Entity cube = gCentralizer->createEntity();
-    gCentralizer->addComponent(cube, ecs::Model{cubeModel});
-    gCentralizer->addComponent(cube, ecs::Transform{{0.f, 0.f, 0.f}, {}, {1.f, 1.f, 1.f}});
-    gCentralizer->addComponent(cube, ecs::Color{{col(gen), col(gen), col(gen)}});
+  PROFILE_ZONE("App::createEntities");
+  const SceneMeshes scene = createScene(*mCentralizer, mSettings.seed, mSettings.bodies);
 
-    ecs::Entity floor = gCentralizer->createEntity();
-    gCentralizer->addComponent(floor, ecs::Model{std::move(cubeModel)});
-    gCentralizer->addComponent(
-        floor, ecs::Transform{{200.f, -2.f, 200.f}, {0.f, 0.f, 0.f}, {400.f, 1.f, 400.f}});
-    gCentralizer->addComponent(floor, ecs::Color{{1.f, 1.f, 1.f}});
+  const ecs::MeshHandle treeMesh = mMeshes.load("models/Tree.obj");
+  const ecs::MeshHandle cubeMesh = mMeshes.load("models/cube.obj");
+  for (ecs::Entity e : scene.trees) {
+    mCentralizer->addComponent(e, ecs::Model{treeMesh});
   }
-
-  // Light
-  {
-    std::vector<glm::vec3> lightColors{
-        {1.f, .1f, .1f}, {.1f, .1f, 1.f}, {.1f, 1.f, .1f},
-        {1.f, 1.f, .1f}, {.1f, 1.f, 1.f}, {1.f, 1.f, 1.f} //
-    };
-
-    for (int i = 0; i < lightColors.size(); i++) {
-      auto rotateLight = glm::rotate(
-          glm::mat4(1.f), (i * glm::two_pi<float>()) / lightColors.size(), {0.f, -1.f, 0.f});
-      ecs::Entity e = gCentralizer->createEntity();
-      gCentralizer->addComponent(
-          e, ecs::Transform{glm::vec3(rotateLight * glm::vec4(-1.f, 1.f, -1.f, 1.f)),
-                            {0.f, 0.f, 0.f},
-                            {0.1f, 0.1f, 0.1f}});
-      gCentralizer->addComponent(e, ecs::Color{lightColors[i]});
-      gCentralizer->addComponent(e, ecs::PointLight{0.2f});
-    }
+  for (ecs::Entity e : scene.cubes) {
+    mCentralizer->addComponent(e, ecs::Model{cubeMesh});
   }
 }
 
 void App::run() {
+  std::unique_ptr<SessionReplayer> replayer{};
+  if (!mSettings.replayPath.empty()) {
+    replayer = std::make_unique<SessionReplayer>(mSettings.replayPath);
+    mSettings.useSession(replayer->header());
+  }
+  std::unique_ptr<SessionRecorder> recorder{};
+  if (!mSettings.recordPath.empty()) {
+    recorder = std::make_unique<SessionRecorder>(mSettings.recordPath, mSettings.sessionHeader());
+  }
+
   // Init the UniformBufferManager first
   ShadowMap sm(mVuDevice);
   sm.createShadowMapRessources();
@@ -178,59 +92,112 @@ void App::run() {
           .addUniformSampler(VK_SHADER_STAGE_ALL_GRAPHICS, sm.getImageView(), sm.getSampler())
           .build();
 
+  // before the systems, some of them observe components
+  registerComponents();
+
   std::shared_ptr<ecs::SimpleRenderSystem> simpleRenderSystem =
-      gCentralizer->registerSystem<ecs::SimpleRenderSystem>(
-          mVuDevice, mVuRenderer.getSwapChainRenderPass(),
+      mCentralizer->registerSystem<ecs::SimpleRenderSystem>(
+          *mCentralizer, mVuDevice, mMeshes, mVuRenderer.getSwapChainRenderPass(),
           mUniformManager->getDescriptorSetLayout());
 
   std::shared_ptr<ecs::PointLightSystem> pointLightSystem =
-      gCentralizer->registerSystem<ecs::PointLightSystem>(
-          mVuDevice, mVuRenderer.getSwapChainRenderPass(),
+      mCentralizer->registerSystem<ecs::PointLightSystem>(
+          *mCentralizer, mVuDevice, mVuRenderer.getSwapChainRenderPass(),
           mUniformManager->getDescriptorSetLayout());
 
   std::shared_ptr<ecs::CameraSystem> cameraSystem =
-      gCentralizer->registerSystem<ecs::CameraSystem>();
+      mCentralizer->registerSystem<ecs::CameraSystem>(*mCentralizer);
 
   std::shared_ptr<ecs::CameraInputSystem> cameraInputSystem =
-      gCentralizer->registerSystem<ecs::CameraInputSystem>(mVuWindow.getGLFWwindow());
+      mCentralizer->registerSystem<ecs::CameraInputSystem>(*mCentralizer);
+
+  const ecs::GravityIntegration integration =
+      mSettings.soaGravity ? ecs::GravityIntegration::SoA : ecs::GravityIntegration::PerEntity;
+  std::shared_ptr<ecs::TransformSystem> transformSystem =
+      mCentralizer->registerSystem<ecs::TransformSystem>(*mCentralizer);
+
+  std::shared_ptr<ecs::HierarchySystem> hierarchySystem =
+      mCentralizer->registerSystem<ecs::HierarchySystem>(*mCentralizer);
 
   std::shared_ptr<ecs::GravitySystem> gravitySystem =
-      gCentralizer->registerSystem<ecs::GravitySystem>();
+      mCentralizer->registerSystem<ecs::GravitySystem>(*mCentralizer, integration);
+  if (mSettings.soaGravity) {
+    std::cout << "Gravity kernel : " << ecs::gravityKernelName() << std::endl;
+  }
 
-  registerComponents();
   setSignatures();
   createEntities();
+  // the render systems walk this group, building it reorders the arrays it owns
+  mCentralizer->group<ecs::Transform, ecs::Model, ecs::Color, ecs::WorldMatrix>();
+
+  for (const ecs::PoolMemoryUsage &pool : mCentralizer->getMemoryUsage()) {
+    std::cout << "ECS pool " << pool.signature << " : " << pool.count << " entities, "
+              << pool.bytes / 1024.f << " KiB" << std::endl;
+  }
 
   cameraSystem->lookAt(ecs::LIGHT_CAMERA_ENTITY, glm::vec3{1.f, -1.f, 1.f});
 
+  ecs::Scheduler scheduler{mCentralizer->getJobSystem()};
+  ecs::FixedTimestep timestep{mSettings.tickRate, mSettings.maxStepsPerFrame};
+  const ecs::Signature transformSignature = ecs::componentSignature<ecs::Transform>();
+  const ecs::Signature previousSignature = ecs::componentSignature<ecs::PreviousTransform>();
+
   auto currentTime = std::chrono::high_resolution_clock::now();
   auto startTime = currentTime;
   while (!mVuWindow.shouldClose()) {
+    PROFILE_ZONE("App::frame");
     glfwPollEvents();
+    mCentralizer->advanceTick();
+    mCentralizer->dispatchEvents();
 
     auto newTime = std::chrono::high_resolution_clock::now();
     float frameTime =
         std::chrono::duration<float, std::chrono::seconds::period>(newTime - currentTime).count();
     currentTime = newTime;
 
-    cameraInputSystem->update(frameTime);
+    // a replay drives the frame time and the input, the window is left for display only
+    SessionFrame session{frameTime, mVuWindow.pollInput()};
+    if (replayer && !replayer->next(session)) {
+      break;
+    }
+    if (recorder) {
+      recorder->record(session);
+    }
+    frameTime = session.frameTime;
+
+    cameraInputSystem->update(frameTime, session.input);
+
+    // simulation, as many fixed steps as the frame time covers
+    const uint32_t steps = timestep.advance(frameTime);
+    for (uint32_t step{0}; step < steps; ++step) {
+      PROFILE_ZONE("App::simulationStep");
+      scheduler.add(transformSignature, previousSignature,
+                    [&] { transformSystem->savePrevious(); });
+      scheduler.add(*gravitySystem, [&] { gravitySystem->update(timestep.step()); });
+      scheduler.run();
+    }
 
     if (auto commandBuffer = mVuRenderer.beginFrame()) {
       int frameIndex = mVuRenderer.getFrameIndex();
       FrameInfo frameInfo{frameIndex, frameTime, commandBuffer,
                           mUniformManager->getGlobalDescriptorSets()[frameIndex]};
 
-      gravitySystem->update(frameInfo);
-
       // declare ubo
       GlobalUbo ubo{};
+      GlobalUbo uboShadows{};
       float aspect = mVuRenderer.getAspectRatio();
-      cameraSystem->update(ubo, aspect, ecs::CAMERA_ENTITY);
 
-      GlobalUbo uboShadows{};
-      cameraSystem->update(uboShadows, aspect, ecs::LIGHT_CAMERA_ENTITY);
+      // cameras write the matrices of the ubo and lights its point lights
+      scheduler.add(*cameraSystem, [&] { cameraSystem->update(ubo, aspect, ecs::CAMERA_ENTITY); });
+      scheduler.add(*cameraSystem,
+                    [&] { cameraSystem->update(uboShadows, aspect, ecs::LIGHT_CAMERA_ENTITY); });
       // simpleRenderSystem->update(frameInfo, ubo);
-      pointLightSystem->update(frameInfo, ubo);
+      scheduler.add(*pointLightSystem, [&] { pointLightSystem->orbit(frameInfo); });
+      // after everything that moves entities, roots before their children
+      scheduler.add(*transformSystem, [&] { transformSystem->update(timestep.alpha()); });
+      scheduler.add(*hierarchySystem, [&] { hierarchySystem->update(); });
+      scheduler.add(*pointLightSystem, [&] { pointLightSystem->update(frameInfo, ubo); });
+      scheduler.run();
 
       float timeUboData =
           std::chrono::duration<float, std::chrono::seconds::period>(newTime - startTime).count();
@@ -254,7 +221,16 @@ void App::run() {
   vkDeviceWaitIdle(mVuDevice.device());
 
   // deleting manually the centralizer
-  gCentralizer = nullptr;
+  mCentralizer = nullptr;
+
+#ifdef MACHINA_PROFILING
+  // the workers are joined, nothing records anymore
+  if (prof::Profiler::get().writeChromeTrace(mSettings.tracePath)) {
+    std::cout << "Trace written to " << mSettings.tracePath << std::endl;
+  } else {
+    std::cerr << "Can't write the trace to " << mSettings.tracePath << std::endl;
+  }
+#endif
 }
 
 } // namespace vu
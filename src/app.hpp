@@ -1,7 +1,10 @@
 #pragma once
 
+#include "ECS/Base/centralizer.hpp"
+#include "simulation_settings.hpp"
 #include "vulkan/descriptors.hpp"
 #include "vulkan/device.hpp"
+#include "vulkan/mesh_registry.hpp"
 #include "vulkan/renderer.hpp"
 #include "vulkan/uniform_buffer.hpp"
 #include "vulkan/window.hpp"
@@ -13,12 +16,15 @@
 #include <vector>
 
 namespace vu {
+
+struct AppSettings : SimulationSettings {};
+
 class App {
 public:
   static constexpr int WIDTH = 1600;
   static constexpr int HEIGHT = 1200;
 
-  App();
+  explicit App(AppSettings settings = {});
   ~App();
 
   App(const App &) = delete;
@@ -31,10 +37,16 @@ private:
   void setSignatures();
   void createEntities();
 
+  AppSettings mSettings;
+
   Window mVuWindow{WIDTH, HEIGHT, "Machina !"};
   Device mVuDevice{mVuWindow};
   Renderer mVuRenderer{mVuWindow, mVuDevice};
+  MeshRegistry mMeshes{mVuDevice};
 
   std::unique_ptr<UniformManager> mUniformManager{};
+
+  // the world, reset in run() before the device goes away
+  std::unique_ptr<ecs::Centralizer> mCentralizer;
 };
 } // namespace vu
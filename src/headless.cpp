@@ -0,0 +1,163 @@
+#include "headless.hpp"
+
+#include "ECS/Base/fixed_timestep.hpp"
+#include "ECS/Base/scheduler.hpp"
+#include "ECS/Systems/camera_input_system.hpp"
+#include "ECS/Systems/camera_system.hpp"
+#include "ECS/Systems/gravity_kernel.hpp"
+#include "ECS/Systems/gravity_system.hpp"
+#include "ECS/Systems/hierarchy_system.hpp"
+#include "ECS/Systems/transform_system.hpp"
+#include "profiler/profiler.hpp"
+#include "scene.hpp"
+
+// libs
+#include <glm/glm.hpp>
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace vu {
+
+namespace {
+// same projection as the windowed app
+constexpr float ASPECT = 1600.f / 1200.f;
+} // namespace
+
+HeadlessApp::HeadlessApp(HeadlessSettings settings)
+    : mSettings{settings}, mCentralizer{std::make_unique<ecs::Centralizer>(settings.backend)} {}
+
+void HeadlessApp::run() {
+  std::unique_ptr<SessionReplayer> replayer{};
+  if (!mSettings.replayPath.empty()) {
+    replayer = std::make_unique<SessionReplayer>(mSettings.replayPath);
+    mSettings.useSession(replayer->header());
+    mSettings.frames = static_cast<uint32_t>(replayer->frameCount());
+  }
+  std::unique_ptr<SessionRecorder> recorder{};
+  if (!mSettings.recordPath.empty()) {
+    recorder = std::make_unique<SessionRecorder>(mSettings.recordPath, mSettings.sessionHeader());
+  }
+
+  registerSceneComponents(*mCentralizer);
+
+  std::shared_ptr<ecs::CameraSystem> cameraSystem =
+      mCentralizer->registerSystem<ecs::CameraSystem>(*mCentralizer);
+  std::shared_ptr<ecs::CameraInputSystem> cameraInputSystem =
+      mCentralizer->registerSystem<ecs::CameraInputSystem>(*mCentralizer);
+  std::shared_ptr<ecs::TransformSystem> transformSystem =
+      mCentralizer->registerSystem<ecs::TransformSystem>(*mCentralizer);
+  std::shared_ptr<ecs::HierarchySystem> hierarchySystem =
+      mCentralizer->registerSystem<ecs::HierarchySystem>(*mCentralizer);
+  const ecs::GravityIntegration integration =
+      mSettings.soaGravity ? ecs::GravityIntegration::SoA : ecs::GravityIntegration::PerEntity;
+  std::shared_ptr<ecs::GravitySystem> gravitySystem =
+      mCentralizer->registerSystem<ecs::GravitySystem>(*mCentralizer, integration);
+  if (mSettings.soaGravity) {
+    std::cout << "Gravity kernel : " << ecs::gravityKernelName() << std::endl;
+  }
+
+  setSimulationSignatures(*mCentralizer);
+  createScene(*mCentralizer, mSettings.seed, mSettings.bodies);
+
+  cameraSystem->lookAt(ecs::LIGHT_CAMERA_ENTITY, glm::vec3{1.f, -1.f, 1.f});
+
+  ecs::Scheduler scheduler{mCentralizer->getJobSystem()};
+  ecs::FixedTimestep timestep{mSettings.tickRate, mSettings.maxStepsPerFrame};
+  const ecs::Signature transformSignature = ecs::componentSignature<ecs::Transform>();
+  const ecs::Signature previousSignature = ecs::componentSignature<ecs::PreviousTransform>();
+
+  using Clock = std::chrono::steady_clock;
+  const bool paced = mSettings.frameRate > 0.f;
+  const auto framePeriod = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<float>(paced ? 1.f / mSettings.frameRate : 0.f));
+
+  uint64_t totalSteps{0};
+  // time spent simulating, the pacing sleep left out
+  double busy{0.0};
+  double longestFrame{0.0};
+  const auto startTime = Clock::now();
+  auto currentTime = startTime;
+  for (uint32_t frame{0}; frame < mSettings.frames; ++frame) {
+    PROFILE_ZONE("HeadlessApp::frame");
+    mCentralizer->advanceTick();
+    mCentralizer->dispatchEvents();
+
+    const auto newTime = Clock::now();
+    const float frameTime = std::chrono::duration<float>(newTime - currentTime).count();
+    currentTime = newTime;
+
+    // uncapped, every frame is one step of simulated time however long it took
+    SessionFrame session{paced ? frameTime : timestep.step(), InputState{}};
+    if (replayer) {
+      replayer->next(session);
+    }
+    if (recorder) {
+      recorder->record(session);
+    }
+
+    cameraInputSystem->update(session.frameTime, session.input);
+
+    const uint32_t steps = timestep.advance(session.frameTime);
+    for (uint32_t step{0}; step < steps; ++step) {
+      PROFILE_ZONE("HeadlessApp::simulationStep");
+      scheduler.add(transformSignature, previousSignature,
+                    [&] { transformSystem->savePrevious(); });
+      scheduler.add(*gravitySystem, [&] { gravitySystem->update(timestep.step()); });
+      scheduler.run();
+    }
+    totalSteps += steps;
+
+    GlobalUbo ubo{};
+    GlobalUbo uboShadows{};
+    scheduler.add(*cameraSystem, [&] { cameraSystem->update(ubo, ASPECT, ecs::CAMERA_ENTITY); });
+    scheduler.add(*cameraSystem,
+                  [&] { cameraSystem->update(uboShadows, ASPECT, ecs::LIGHT_CAMERA_ENTITY); });
+    scheduler.add(*transformSystem, [&] { transformSystem->update(timestep.alpha()); });
+    scheduler.add(*hierarchySystem, [&] { hierarchySystem->update(); });
+    scheduler.run();
+
+    const double work = std::chrono::duration<double>(Clock::now() - newTime).count();
+    busy += work;
+    longestFrame = std::max(longestFrame, work);
+    if (paced) {
+      std::this_thread::sleep_until(newTime + framePeriod);
+    }
+  }
+  const double seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+
+  // body heights and camera positions, two runs of the same session print the same value
+  double checksum{0.0};
+  mCentralizer->view<ecs::Gravity, ecs::Transform>().each(
+      [&](ecs::Entity, ecs::Gravity &, ecs::Transform &transform) {
+        checksum += transform.position().y;
+      });
+  mCentralizer->view<ecs::Camera, ecs::Transform>().each(
+      [&](ecs::Entity, ecs::Camera &, ecs::Transform &transform) {
+        checksum += transform.position().x + transform.position().y + transform.position().z;
+      });
+
+  std::cout << "Headless : " << mSettings.frames << " frames, " << totalSteps << " steps of "
+            << mSettings.bodies << " bodies in " << seconds << " s" << std::endl;
+  std::cout << "  " << mSettings.frames / seconds << " frames/s, " << totalSteps / seconds
+            << " steps/s, " << totalSteps * mSettings.bodies / seconds << " body steps/s"
+            << std::endl;
+  std::cout << "  frame avg " << busy * 1000.0 / std::max(mSettings.frames, 1u) << " ms, max "
+            << longestFrame * 1000.0 << " ms" << std::endl;
+  std::cout << "  checksum " << checksum << std::endl;
+
+  mCentralizer = nullptr;
+
+#ifdef MACHINA_PROFILING
+  if (prof::Profiler::get().writeChromeTrace(mSettings.tracePath)) {
+    std::cout << "Trace written to " << mSettings.tracePath << std::endl;
+  } else {
+    std::cerr << "Can't write the trace to " << mSettings.tracePath << std::endl;
+  }
+#endif
+}
+
+} // namespace vu
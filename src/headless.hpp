@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ECS/Base/centralizer.hpp"
+#include "simulation_settings.hpp"
+
+// std
+#include <cstdint>
+#include <memory>
+
+namespace vu {
+
+struct HeadlessSettings : SimulationSettings {
+  // frames to run, a replay runs all of its frames instead
+  uint32_t frames{1000};
+  // 0 runs the frames back to back with exactly one simulation step each, otherwise
+  // the frames are paced at that rate and the simulation steps follow the wall clock.
+  // A replay uses the recorded frame times.
+  float frameRate{0.f};
+};
+
+// Runs the simulation systems (gravity, transform and hierarchy propagation, cameras)
+// without a window, a Vulkan device or a renderer, then prints the throughput.
+// Each HeadlessApp owns its world, several can run at once on separate threads.
+class HeadlessApp {
+public:
+  explicit HeadlessApp(HeadlessSettings settings = {});
+
+  HeadlessApp(const HeadlessApp &) = delete;
+  HeadlessApp &operator=(const HeadlessApp &) = delete;
+
+  void run();
+
+private:
+  HeadlessSettings mSettings;
+  // reset at the end of run(), which joins the workers of its job system
+  std::unique_ptr<ecs::Centralizer> mCentralizer;
+};
+} // namespace vu
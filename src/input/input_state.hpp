@@ -0,0 +1,33 @@
+#pragma once
+
+// std
+#include <cstdint>
+
+namespace vu {
+
+// Actions the player can hold down, one bit each in InputState
+enum class InputButton : uint16_t {
+  MoveLeft,
+  MoveRight,
+  MoveForward,
+  MoveBackward,
+  MoveUp,
+  MoveDown,
+  LookLeft,
+  LookRight,
+  LookUp,
+  LookDown,
+};
+
+// Buttons held during a frame. Filled from the window (Window::pollInput) or from a
+// recorded session, the systems never query the keyboard themselves.
+struct InputState {
+  uint16_t buttons{0};
+
+  bool pressed(InputButton button) const {
+    return buttons & (1u << static_cast<uint16_t>(button));
+  }
+
+  void press(InputButton button) { buttons |= 1u << static_cast<uint16_t>(button); }
+};
+} // namespace vu
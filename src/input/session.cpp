@@ -0,0 +1,73 @@
+#include "session.hpp"
+
+// std
+#include <cstring>
+#include <stdexcept>
+
+namespace vu {
+
+namespace {
+constexpr char MAGIC[8] = {'M', 'C', 'H', 'S', 'E', 'S', 'S', '\0'};
+constexpr uint32_t VERSION = 1;
+
+template <typename T> void write(std::ofstream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> bool read(std::ifstream &in, T &value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+} // namespace
+
+SessionRecorder::SessionRecorder(const std::string &path, const SessionHeader &header)
+    : mOut{path, std::ios::binary | std::ios::trunc} {
+  if (!mOut) {
+    throw std::runtime_error("failed to open session file " + path);
+  }
+  mOut.write(MAGIC, sizeof(MAGIC));
+  write(mOut, VERSION);
+  write(mOut, header.seed);
+  write(mOut, header.tickRate);
+  write(mOut, header.maxStepsPerFrame);
+  write(mOut, header.bodies);
+}
+
+void SessionRecorder::record(const SessionFrame &frame) {
+  write(mOut, frame.frameTime);
+  write(mOut, frame.input.buttons);
+}
+
+SessionReplayer::SessionReplayer(const std::string &path) {
+  std::ifstream in{path, std::ios::binary};
+  if (!in) {
+    throw std::runtime_error("failed to open session file " + path);
+  }
+
+  char magic[sizeof(MAGIC)];
+  uint32_t version{0};
+  if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      !read(in, version) || version != VERSION || !read(in, mHeader.seed) ||
+      !read(in, mHeader.tickRate) || !read(in, mHeader.maxStepsPerFrame) ||
+      !read(in, mHeader.bodies)) {
+    throw std::runtime_error("not a session file " + path);
+  }
+  if (!(mHeader.tickRate > 0.f) || mHeader.maxStepsPerFrame == 0) {
+    throw std::runtime_error("invalid session settings in " + path);
+  }
+
+  // a frame cut short by a crash while recording is dropped
+  SessionFrame frame{};
+  while (read(in, frame.frameTime) && read(in, frame.input.buttons)) {
+    mFrames.push_back(frame);
+  }
+}
+
+bool SessionReplayer::next(SessionFrame &frame) {
+  if (mNext == mFrames.size()) {
+    return false;
+  }
+  frame = mFrames[mNext++];
+  return true;
+}
+
+} // namespace vu
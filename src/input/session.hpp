@@ -0,0 +1,61 @@
+#pragma once
+
+#include "input_state.hpp"
+
+// std
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace vu {
+
+// Everything a session needs to start the same way, at the head of the stream
+struct SessionHeader {
+  uint32_t seed{0};
+  float tickRate{60.f};
+  uint32_t maxStepsPerFrame{5};
+  // falling bodies of the scene
+  uint32_t bodies{0};
+};
+
+// One frame of a session
+struct SessionFrame {
+  float frameTime{0.f};
+  InputState input{};
+};
+
+// Writes a session as it is played: the header, then 6 bytes per frame (frame time and
+// held buttons). Native endianness, a stream is replayed on the machine kind that
+// recorded it. Throws when the file can't be opened.
+class SessionRecorder {
+public:
+  SessionRecorder(const std::string &path, const SessionHeader &header);
+
+  SessionRecorder(const SessionRecorder &) = delete;
+  SessionRecorder &operator=(const SessionRecorder &) = delete;
+
+  void record(const SessionFrame &frame);
+
+private:
+  std::ofstream mOut;
+};
+
+// Reads a whole session written by SessionRecorder, then hands its frames back in order.
+// Throws when the file can't be read or isn't a session stream.
+class SessionReplayer {
+public:
+  explicit SessionReplayer(const std::string &path);
+
+  const SessionHeader &header() const { return mHeader; }
+  size_t frameCount() const { return mFrames.size(); }
+
+  // False once every frame was replayed
+  bool next(SessionFrame &frame);
+
+private:
+  SessionHeader mHeader{};
+  std::vector<SessionFrame> mFrames{};
+  size_t mNext{0};
+};
+} // namespace vu
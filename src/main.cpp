@@ -33,29 +33,86 @@
 // 	return 0;
 // }
 
+#ifndef MACHINA_HEADLESS_ONLY
 #include "app.hpp"
+#endif
+#include "headless.hpp"
 
 // std
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <random>
 #include <stdexcept>
 
-#include "ECS/ECS.hpp"
-
-std::unique_ptr<ecs::Centralizer> gCentralizer{};
-
-int main() {
-
-  gCentralizer = std::make_unique<ecs::Centralizer>();
+int main(int argc, char **argv) {
+  // --archetype runs the same scene on the archetype storage backend
+  // --soa integrates gravity with the vectorized SoA kernel
+  // --tick-rate <hz> and --max-steps <n> configure the fixed step simulation
+  // --trace <file> is where a MACHINA_PROFILING build writes its Chrome trace
+  // --bodies <n> and --seed <n> shape the scene, the windowed app draws a seed if none given
+  // --record <file> writes the session, --replay <file> plays one back with its settings
+  // --headless runs the simulation only, without window nor GPU (always on for the
+  //   machina_headless build), with:
+  //   --frames <n>, --frame-rate <hz> (0 is uncapped)
+#ifdef MACHINA_HEADLESS_ONLY
+  bool headless = true;
+#else
+  bool headless = false;
+#endif
+  // every option lands there, the windowed app only takes the SimulationSettings part
+  vu::HeadlessSettings headlessSettings{};
+  bool seeded = false;
+  for (int i{1}; i < argc; ++i) {
+    const bool hasValue = i + 1 < argc;
+    if (std::strcmp(argv[i], "--archetype") == 0) {
+      headlessSettings.backend = ecs::StorageBackend::Archetype;
+    } else if (std::strcmp(argv[i], "--headless") == 0) {
+      headless = true;
+    } else if (std::strcmp(argv[i], "--soa") == 0) {
+      headlessSettings.soaGravity = true;
+    } else if (std::strcmp(argv[i], "--tick-rate") == 0 && hasValue) {
+      headlessSettings.tickRate = std::strtof(argv[++i], nullptr);
+    } else if (std::strcmp(argv[i], "--max-steps") == 0 && hasValue) {
+      headlessSettings.maxStepsPerFrame =
+          static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(argv[i], "--trace") == 0 && hasValue) {
+      headlessSettings.tracePath = argv[++i];
+    } else if (std::strcmp(argv[i], "--frames") == 0 && hasValue) {
+      headlessSettings.frames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(argv[i], "--frame-rate") == 0 && hasValue) {
+      headlessSettings.frameRate = std::strtof(argv[++i], nullptr);
+    } else if (std::strcmp(argv[i], "--bodies") == 0 && hasValue) {
+      headlessSettings.bodies = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+      headlessSettings.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+      seeded = true;
+    } else if (std::strcmp(argv[i], "--record") == 0 && hasValue) {
+      headlessSettings.recordPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--replay") == 0 && hasValue) {
+      headlessSettings.replayPath = argv[++i];
+    }
+  }
 
-  vu::App app{};
+  // a headless run is reproducible by default, the windowed scene differs on each launch
+  if (!seeded && !headless) {
+    headlessSettings.seed = std::random_device{}();
+  }
 
   try {
-    app.run();
+    if (headless) {
+      vu::HeadlessApp app{headlessSettings};
+      app.run();
+    } else {
+#ifndef MACHINA_HEADLESS_ONLY
+      vu::App app{vu::AppSettings{headlessSettings}};
+      app.run();
+#endif
+    }
   } catch (const std::exception &e) {
     std::cerr << e.what() << '\n';
     return EXIT_FAILURE;
   }
 
   return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
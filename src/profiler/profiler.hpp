@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Scoped instrumentation zones, compiled out unless MACHINA_PROFILING is defined:
+//   PROFILE_ZONE("Renderer::beginFrame");
+// Every thread records into its own ring buffer, writeChromeTrace dumps all of them
+// in the Chrome trace format (chrome://tracing or ui.perfetto.dev).
+#ifdef MACHINA_PROFILING
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_ZONE(name) ::prof::Zone PROFILE_CONCAT(profileZone, __LINE__){name}
+#define PROFILE_THREAD(name) ::prof::Profiler::get().setThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
+
+namespace prof {
+
+// Name must outlive the profiler, zones are meant to be named with string literals
+struct ZoneEvent {
+  const char *name{nullptr};
+  // nanoseconds since the profiler started
+  uint64_t begin{0};
+  uint64_t end{0};
+};
+
+// Zones of one thread. Only that thread pushes, without any lock; the head is published
+// with release so a reader never sees a half written event. Once full, the oldest events
+// are overwritten.
+class ThreadBuffer {
+public:
+  static constexpr size_t CAPACITY = 1 << 16;
+
+  explicit ThreadBuffer(uint32_t id) : mId{id} {}
+
+  void push(const ZoneEvent &event) {
+    const uint64_t head = mHead.load(std::memory_order_relaxed);
+    mEvents[head % CAPACITY] = event;
+    mHead.store(head + 1, std::memory_order_release);
+  }
+
+  // Events still in the ring, oldest first. Read it while the thread doesn't record,
+  // an event overwritten during the copy would be torn.
+  std::vector<ZoneEvent> events() const {
+    const uint64_t head = mHead.load(std::memory_order_acquire);
+    const uint64_t first = head > CAPACITY ? head - CAPACITY : 0;
+    std::vector<ZoneEvent> events;
+    events.reserve(head - first);
+    for (uint64_t i{first}; i < head; ++i) {
+      events.push_back(mEvents[i % CAPACITY]);
+    }
+    return events;
+  }
+
+  uint32_t id() const { return mId; }
+
+private:
+  friend class Profiler;
+
+  std::unique_ptr<ZoneEvent[]> mEvents{new ZoneEvent[CAPACITY]};
+  std::atomic<uint64_t> mHead{0};
+  uint32_t mId;
+  // guarded by the profiler mutex
+  std::string mName{};
+};
+
+class Profiler {
+public:
+  static Profiler &get() {
+    static Profiler profiler;
+    return profiler;
+  }
+
+  uint64_t now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - mEpoch)
+        .count();
+  }
+
+  // Buffer of the calling thread, created on its first zone. Buffers belong to the
+  // profiler so the zones of a thread are kept after it exits.
+  ThreadBuffer &threadBuffer() {
+    thread_local ThreadBuffer *buffer = registerThread();
+    return *buffer;
+  }
+
+  void setThreadName(std::string name) {
+    ThreadBuffer &buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock{mMutex};
+    buffer.mName = std::move(name);
+  }
+
+  // Write every recorded zone as Chrome trace complete events. Call it while the other
+  // threads are idle, e.g. between two frames or at exit.
+  bool writeChromeTrace(const std::string &path) {
+    FILE *file = std::fopen(path.c_str(), "w");
+    if (!file) {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock{mMutex};
+    std::fprintf(file, "{\"traceEvents\": [\n");
+    const char *separator = "";
+    for (const auto &buffer : mBuffers) {
+      if (!buffer->mName.empty()) {
+        std::fprintf(file,
+                     "%s  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %u, "
+                     "\"args\": {\"name\": \"%s\"}}",
+                     separator, buffer->id(), escape(buffer->mName.c_str()).c_str());
+        separator = ",\n";
+      }
+      for (const ZoneEvent &event : buffer->events()) {
+        std::fprintf(file,
+                     "%s  {\"name\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": %u, "
+                     "\"ts\": %.3f, \"dur\": %.3f}",
+                     separator, escape(event.name).c_str(), buffer->id(), event.begin / 1000.0,
+                     (event.end - event.begin) / 1000.0);
+        separator = ",\n";
+      }
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+  }
+
+private:
+  Profiler() = default;
+
+  ThreadBuffer *registerThread() {
+    std::lock_guard<std::mutex> lock{mMutex};
+    mBuffers.push_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(mBuffers.size())));
+    return mBuffers.back().get();
+  }
+
+  static std::string escape(const char *text) {
+    std::string escaped;
+    for (; *text; ++text) {
+      if (*text == '"' || *text == '\\') {
+        escaped += '\\';
+      }
+      escaped += *text;
+    }
+    return escaped;
+  }
+
+  const std::chrono::steady_clock::time_point mEpoch{std::chrono::steady_clock::now()};
+  std::mutex mMutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> mBuffers{};
+};
+
+// Record the time between its construction and destruction, see PROFILE_ZONE
+class Zone {
+public:
+  explicit Zone(const char *name) : mName{name}, mBegin{Profiler::get().now()} {}
+
+  ~Zone() {
+    Profiler &profiler = Profiler::get();
+    profiler.threadBuffer().push(ZoneEvent{mName, mBegin, profiler.now()});
+  }
+
+  Zone(const Zone &) = delete;
+  Zone &operator=(const Zone &) = delete;
+
+private:
+  const char *mName;
+  uint64_t mBegin;
+};
+
+} // namespace prof
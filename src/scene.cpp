@@ -0,0 +1,192 @@
+#include "scene.hpp"
+
+#include "ECS/Base/centralizer.hpp"
+#include "ECS/Components/camera.hpp"
+#include "ECS/Components/color.hpp"
+#include "ECS/Components/gravity.hpp"
+#include "ECS/Components/hierarchy.hpp"
+#include "ECS/Components/local_transform.hpp"
+#include "ECS/Components/point_light.hpp"
+#include "ECS/Components/previous_transform.hpp"
+#include "ECS/Components/rigid_body.hpp"
+#include "ECS/Components/transform.hpp"
+#include "ECS/Components/world_matrix.hpp"
+#include "ECS/Systems/camera_input_system.hpp"
+#include "ECS/Systems/camera_system.hpp"
+#include "ECS/Systems/gravity_system.hpp"
+#include "ECS/Systems/hierarchy_system.hpp"
+#include "ECS/Systems/transform_system.hpp"
+#include "profiler/profiler.hpp"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <tuple>
+
+namespace vu {
+
+void registerSceneComponents(ecs::Centralizer &centralizer) {
+  centralizer.registerComponent<ecs::Transform>();
+  centralizer.registerComponent<ecs::Color>();
+  centralizer.registerComponent<ecs::PointLight>();
+  centralizer.registerComponent<ecs::Camera>();
+  centralizer.registerComponent<ecs::Gravity>();
+  centralizer.registerComponent<ecs::RigidBody>();
+  centralizer.registerComponent<ecs::WorldMatrix>();
+  centralizer.registerComponent<ecs::Parent>();
+  centralizer.registerComponent<ecs::Children>();
+  centralizer.registerComponent<ecs::LocalTransform>();
+  centralizer.registerComponent<ecs::PreviousTransform>();
+}
+
+void setSimulationSignatures(ecs::Centralizer &centralizer) {
+  ecs::Signature transformSignature;
+  transformSignature.set(centralizer.getComponentType<ecs::Transform>());
+  transformSignature.set(centralizer.getComponentType<ecs::WorldMatrix>());
+  centralizer.setSystemSignature<ecs::TransformSystem>(transformSignature);
+
+  ecs::Signature hierarchySignature;
+  hierarchySignature.set(centralizer.getComponentType<ecs::Parent>());
+  hierarchySignature.set(centralizer.getComponentType<ecs::LocalTransform>());
+  hierarchySignature.set(centralizer.getComponentType<ecs::WorldMatrix>());
+  centralizer.setSystemSignature<ecs::HierarchySystem>(hierarchySignature);
+
+  ecs::Signature cameraSignature;
+  cameraSignature.set(centralizer.getComponentType<ecs::Camera>());
+  cameraSignature.set(centralizer.getComponentType<ecs::Transform>());
+  centralizer.setSystemSignature<ecs::CameraSystem>(cameraSignature);
+  centralizer.setSystemSignature<ecs::CameraInputSystem>(cameraSignature);
+
+  ecs::Signature gravitySignature;
+  gravitySignature.set(centralizer.getComponentType<ecs::Transform>());
+  gravitySignature.set(centralizer.getComponentType<ecs::Gravity>());
+  gravitySignature.set(centralizer.getComponentType<ecs::RigidBody>());
+  centralizer.setSystemSignature<ecs::GravitySystem>(gravitySignature);
+}
+
+SceneMeshes createScene(ecs::Centralizer &centralizer, uint32_t seed, uint32_t bodies) {
+  PROFILE_ZONE("createScene");
+  SceneMeshes meshes{};
+
+  // Camera, first so they get CAMERA_ENTITY and LIGHT_CAMERA_ENTITY
+  {
+    ecs::Entity e = centralizer.createEntity();
+    centralizer.addComponent(e, ecs::Camera{});
+    centralizer.addComponent(e, ecs::Transform{{1.f, 1.f, 1.5f}, {}, {}});
+
+    e = centralizer.createEntity();
+    centralizer.addComponent(e, ecs::Camera{});
+    centralizer.addComponent(e, ecs::Transform{{0.f, 200.f, -2.5f}, {}, {}});
+  }
+
+  std::mt19937 gen(seed);
+  // Object
+  {
+    std::uniform_real_distribution<float> col(0.0f, 1.0f);
+    std::uniform_real_distribution<float> dis(4.0f, 16.0f);
+
+    // every tree stands on a cube, both share the same spot of the 5x5 grid
+    struct Spot {
+      float h;
+      float xOff;
+      float zOff;
+    };
+    std::vector<Spot> spots(5 * 5);
+    for (Spot &spot : spots) {
+      spot.h = col(gen) * 5;
+      spot.xOff = (col(gen) - 0.5) * 5.f;
+      spot.zOff = (col(gen) - 0.5) * 5.f;
+    }
+
+    // the WorldMatrix is filled by the TransformSystem on the first frame
+    meshes.trees = centralizer.spawnBatch<ecs::Transform, ecs::Color, ecs::WorldMatrix>(
+        spots.size(), [&](size_t k) {
+          const size_t i = k / 5, j = k % 5;
+          return std::tuple{
+              ecs::Transform{{i * 10 + spots[k].xOff, 0.4f + spots[k].h, j * 10 + spots[k].zOff},
+                             {col(gen) * glm::radians(10.f), col(gen) * glm::radians(360.f), 0.f},
+                             {3.f, 3.f, 3.f}},
+              ecs::Color{{col(gen), col(gen), col(gen)}}, ecs::WorldMatrix{}};
+        });
+
+    meshes.cubes = centralizer.spawnBatch<ecs::Transform, ecs::Color, ecs::WorldMatrix>(
+        spots.size(), [&](size_t k) {
+          const size_t i = k / 5, j = k % 5;
+          return std::tuple{
+              ecs::Transform{{i * 10 + spots[k].xOff, -.5f + spots[k].h, j * 10 + spots[k].zOff},
+                             {0.f, 0.f, 0.f},
+                             {1.f, 1.f, 1.f}},
+              ecs::Color{{col(gen), col(gen), col(gen)}}, ecs::WorldMatrix{}};
+        });
+
+    // falling bodies are simulated at the fixed tick rate and rendered in between two steps
+    const uint32_t side =
+        std::max<uint32_t>(static_cast<uint32_t>(std::ceil(std::sqrt(float(bodies)))), 1);
+    std::vector<ecs::Entity> falling =
+        centralizer.spawnBatch<ecs::Transform, ecs::PreviousTransform, ecs::Color, ecs::Gravity,
+                                 ecs::RigidBody, ecs::WorldMatrix>(bodies, [&](size_t k) {
+          const size_t i = k / side, j = k % side;
+          const ecs::Transform transform{
+              {static_cast<float>(i * 10), 30.f, static_cast<float>(j * 10)},
+              {col(gen) * glm::radians(360.f), col(gen) * glm::radians(360.f),
+               col(gen) * glm::radians(360.f)},
+              {col(gen), col(gen), col(gen)}};
+          return std::tuple{transform, ecs::PreviousTransform{transform},
+                            ecs::Color{{col(gen), col(gen), col(gen)}},
+                            ecs::Gravity{{0.f, ecs::GRAVITY_CONSTANT, 0.f}},
+                            ecs::RigidBody{{}, {}, dis(gen) / 10.f}, ecs::WorldMatrix{}};
+        });
+    meshes.cubes.insert(meshes.cubes.end(), falling.begin(), falling.end());
+
+    ecs::Entity cube = centralizer.createEntity();
+    centralizer.addComponent(cube, ecs::Transform{{0.f, 0.f, 0.f}, {}, {1.f, 1.f, 1.f}});
+    centralizer.addComponent(cube, ecs::Color{{col(gen), col(gen), col(gen)}});
+    centralizer.addComponent(cube, ecs::WorldMatrix{});
+    meshes.cubes.push_back(cube);
+
+    ecs::Entity floor = centralizer.createEntity();
+    centralizer.addComponent(
+        floor, ecs::Transform{{200.f, -2.f, 200.f}, {0.f, 0.f, 0.f}, {400.f, 1.f, 400.f}});
+    centralizer.addComponent(floor, ecs::Color{{1.f, 1.f, 1.f}});
+    centralizer.addComponent(floor, ecs::WorldMatrix{});
+    meshes.cubes.push_back(floor);
+  }
+
+  // Light, orbiting a pivot they are attached to
+  {
+    std::vector<glm::vec3> lightColors{
+        {1.f, .1f, .1f}, {.1f, .1f, 1.f}, {.1f, 1.f, .1f},
+        {1.f, 1.f, .1f}, {.1f, 1.f, 1.f}, {1.f, 1.f, 1.f} //
+    };
+
+    ecs::Entity pivot = centralizer.createEntity();
+    centralizer.addComponent(pivot, ecs::Transform{{0.f, 0.f, 0.f}, {}, {1.f, 1.f, 1.f}});
+    centralizer.addComponent(pivot, ecs::WorldMatrix{});
+
+    // the Transform only carries the radius, the HierarchySystem fills its position
+    std::vector<ecs::Entity> lights =
+        centralizer.spawnBatch<ecs::Transform, ecs::LocalTransform, ecs::Color, ecs::PointLight,
+                                 ecs::WorldMatrix>(lightColors.size(), [&](size_t i) {
+          auto rotateLight = glm::rotate(
+              glm::mat4(1.f), (i * glm::two_pi<float>()) / lightColors.size(), {0.f, -1.f, 0.f});
+          const glm::vec3 offset{rotateLight * glm::vec4(-1.f, 1.f, -1.f, 1.f)};
+          return std::tuple{ecs::Transform{offset, {0.f, 0.f, 0.f}, {0.1f, 0.1f, 0.1f}},
+                            ecs::LocalTransform{{offset, {0.f, 0.f, 0.f}, {1.f, 1.f, 1.f}}},
+                            ecs::Color{lightColors[i]}, ecs::PointLight{0.2f}, ecs::WorldMatrix{}};
+        });
+    for (ecs::Entity light : lights) {
+      ecs::HierarchySystem::attach(centralizer, light, pivot);
+    }
+  }
+
+  return meshes;
+}
+
+} // namespace vu
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "ECS/Base/centralizer.hpp"
+
+// std
+#include <cstdint>
+#include <vector>
+
+namespace vu {
+
+// Entities of the scene drawn with each mesh, the windowed app gives them their Model
+struct SceneMeshes {
+  std::vector<ecs::Entity> trees{};
+  std::vector<ecs::Entity> cubes{};
+};
+
+// Every component of the scene but Model, which needs the GPU
+void registerSceneComponents(ecs::Centralizer &centralizer);
+
+// Signatures of the systems running without a GPU: gravity, transform, hierarchy, cameras.
+// The systems have to be registered already.
+void setSimulationSignatures(ecs::Centralizer &centralizer);
+
+// Cameras, props on a 5x5 grid, `bodies` falling bodies on a square grid and lights
+// orbiting a pivot. Everything random is drawn from `seed`, the same seed and body count
+// always give the same scene, with or without rendering.
+SceneMeshes createScene(ecs::Centralizer &centralizer, uint32_t seed, uint32_t bodies);
+
+} // namespace vu
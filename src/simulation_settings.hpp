@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ECS/Base/centralizer.hpp"
+#include "input/session.hpp"
+
+// std
+#include <cstdint>
+#include <string>
+
+namespace vu {
+
+// Options shared by App and HeadlessApp, picked on the command line, see main.cpp
+struct SimulationSettings {
+  // storage of the world the app creates
+  ecs::StorageBackend backend{ecs::StorageBackend::SparseSet};
+  // integrate the falling bodies with the vectorized SoA kernel
+  bool soaGravity{false};
+  // fixed simulation steps per second, and at most this many steps per frame
+  float tickRate{60.f};
+  uint32_t maxStepsPerFrame{5};
+  // falling bodies of the scene, and the seed everything random in it is drawn from
+  uint32_t bodies{100};
+  uint32_t seed{0};
+  // Chrome trace written at exit when built with MACHINA_PROFILING
+  std::string tracePath{"machina_trace.json"};
+  // write the session to recordPath, or play the one at replayPath instead of the live
+  // input and clock, see SessionRecorder
+  std::string recordPath{};
+  std::string replayPath{};
+
+  SessionHeader sessionHeader() const {
+    return SessionHeader{seed, tickRate, maxStepsPerFrame, bodies};
+  }
+
+  // A replay runs with the settings it was recorded with
+  void useSession(const SessionHeader &header) {
+    seed = header.seed;
+    tickRate = header.tickRate;
+    maxStepsPerFrame = header.maxStepsPerFrame;
+    bodies = header.bodies;
+  }
+};
+} // namespace vu
@@ -0,0 +1,27 @@
+#include "mesh_registry.hpp"
+
+// std
+#include <cassert>
+
+namespace vu {
+
+MeshRegistry::MeshRegistry(Device &device) : mVuDevice{device} {}
+
+ecs::MeshHandle MeshRegistry::load(const std::string &filepath) {
+  if (auto it = mHandles.find(filepath); it != mHandles.end()) {
+    return it->second;
+  }
+  assert(mMeshes.size() < ecs::INVALID_MESH && "load : Too many meshes.");
+
+  const auto handle = static_cast<ecs::MeshHandle>(mMeshes.size());
+  mMeshes.push_back(Model::createModelFromFile(mVuDevice, filepath));
+  mHandles.emplace(filepath, handle);
+  return handle;
+}
+
+Model &MeshRegistry::get(ecs::MeshHandle handle) {
+  assert(handle < mMeshes.size() && "get : Invalid mesh handle.");
+  return *mMeshes[handle];
+}
+
+} // namespace vu
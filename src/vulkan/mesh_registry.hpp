@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../ECS/Components/model.hpp"
+#include "device.hpp"
+#include "model.hpp"
+
+// std
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vu {
+
+// Owns every mesh of the app, entities refer to them through the ecs::MeshHandle of their
+// ecs::Model. A file is loaded once, loading it again returns the same handle.
+// Handles stay valid as long as the registry lives.
+class MeshRegistry {
+public:
+  explicit MeshRegistry(Device &device);
+
+  MeshRegistry(const MeshRegistry &) = delete;
+  MeshRegistry &operator=(const MeshRegistry &) = delete;
+
+  ecs::MeshHandle load(const std::string &filepath);
+
+  Model &get(ecs::MeshHandle handle);
+
+  size_t size() const { return mMeshes.size(); }
+
+private:
+  Device &mVuDevice;
+
+  std::vector<std::unique_ptr<Model>> mMeshes{};
+  std::unordered_map<std::string, ecs::MeshHandle> mHandles{};
+};
+} // namespace vu
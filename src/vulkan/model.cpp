@@ -1,5 +1,6 @@
 #include "model.hpp"
 
+#include "../profiler/profiler.hpp"
 #include "utils.hpp"
 
 // libs
@@ -38,6 +39,7 @@ Model::Model(Device &device, const Model::Builder &builder) : mVuDevice{device}
 Model::~Model() {}
 
 std::unique_ptr<Model> Model::createModelFromFile(Device &device, const std::string &filepath) {
+  PROFILE_ZONE("Model::createModelFromFile");
   Builder builder{};
   builder.loadModel(ENGINE_DIR + filepath);
   return std::make_unique<Model>(device, builder);
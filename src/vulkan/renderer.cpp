@@ -1,5 +1,7 @@
 #include "renderer.hpp"
 
+#include "../profiler/profiler.hpp"
+
 // std
 #include <array>
 #include <cassert>
@@ -56,6 +58,7 @@ void Renderer::freeCommandBuffers() {
 }
 
 VkCommandBuffer Renderer::beginFrame() {
+  PROFILE_ZONE("Renderer::beginFrame");
   assert(!mIsFrameStarted && "Can't call beginFrame while already in progress");
 
   auto result = mSwapChain->acquireNextImage(&mCurrentImageIndex);
@@ -81,6 +84,7 @@ VkCommandBuffer Renderer::beginFrame() {
 }
 
 void Renderer::endFrame() {
+  PROFILE_ZONE("Renderer::endFrame");
   assert(mIsFrameStarted && "Can't call endFrame while frame is not in progress");
   auto commandBuffer = getCurrentCommandBuffer();
   if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
@@ -1,5 +1,7 @@
 #include "swap_chain.hpp"
 
+#include "../profiler/profiler.hpp"
+
 // std
 #include <array>
 #include <cstdlib>
@@ -63,9 +65,13 @@ SwapChain::~SwapChain() {
 }
 
 VkResult SwapChain::acquireNextImage(uint32_t *imageIndex) {
-  vkWaitForFences(mVuDevice.device(), 1, &mInFlightFences[mCurrentFrame], VK_TRUE,
-                  std::numeric_limits<uint64_t>::max());
+  {
+    PROFILE_ZONE("SwapChain::waitInFlightFence");
+    vkWaitForFences(mVuDevice.device(), 1, &mInFlightFences[mCurrentFrame], VK_TRUE,
+                    std::numeric_limits<uint64_t>::max());
+  }
 
+  PROFILE_ZONE("SwapChain::acquireNextImage");
   VkResult result =
       vkAcquireNextImageKHR(mVuDevice.device(), mSwapChain, std::numeric_limits<uint64_t>::max(),
                             mImageAvailableSemaphores[mCurrentFrame], // must be a not signaled
@@ -77,6 +83,7 @@ VkResult SwapChain::acquireNextImage(uint32_t *imageIndex) {
 
 VkResult SwapChain::submitCommandBuffers(const VkCommandBuffer *buffers, uint32_t *imageIndex) {
   if (mImagesInFlight[*imageIndex] != VK_NULL_HANDLE) {
+    PROFILE_ZONE("SwapChain::waitImageFence");
     vkWaitForFences(mVuDevice.device(), 1, &mImagesInFlight[*imageIndex], VK_TRUE, UINT64_MAX);
   }
   mImagesInFlight[*imageIndex] = mInFlightFences[mCurrentFrame];
@@ -2,6 +2,7 @@
 
 // std
 #include <stdexcept>
+#include <utility>
 
 namespace vu {
 
@@ -30,6 +31,29 @@ void Window::createWindowSurface(VkInstance instance, VkSurfaceKHR *surface) {
   }
 }
 
+InputState Window::pollInput() const {
+  const std::pair<int, InputButton> bindings[] = {
+      {mKeys.moveLeft, InputButton::MoveLeft},
+      {mKeys.moveRight, InputButton::MoveRight},
+      {mKeys.moveForward, InputButton::MoveForward},
+      {mKeys.moveBackward, InputButton::MoveBackward},
+      {mKeys.moveUp, InputButton::MoveUp},
+      {mKeys.moveDown, InputButton::MoveDown},
+      {mKeys.lookLeft, InputButton::LookLeft},
+      {mKeys.lookRight, InputButton::LookRight},
+      {mKeys.lookUp, InputButton::LookUp},
+      {mKeys.lookDown, InputButton::LookDown},
+  };
+
+  InputState input{};
+  for (const auto &[key, button] : bindings) {
+    if (glfwGetKey(mWindow, key) == GLFW_PRESS) {
+      input.press(button);
+    }
+  }
+  return input;
+}
+
 void Window::framebufferResizeCallback(GLFWwindow *window, int width, int height) {
   auto mVuWindow = reinterpret_cast<Window *>(glfwGetWindowUserPointer(window));
   mVuWindow->mFramebufferResized = true;
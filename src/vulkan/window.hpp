@@ -3,11 +3,27 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
+#include "../input/input_state.hpp"
+
 #include <string>
 namespace vu {
 
 class Window {
 public:
+  // GLFW key of each InputButton
+  struct KeyMappings {
+    int moveLeft = GLFW_KEY_A;
+    int moveRight = GLFW_KEY_D;
+    int moveForward = GLFW_KEY_W;
+    int moveBackward = GLFW_KEY_S;
+    int moveUp = GLFW_KEY_SPACE;
+    int moveDown = GLFW_KEY_LEFT_SHIFT;
+    int lookLeft = GLFW_KEY_LEFT;
+    int lookRight = GLFW_KEY_RIGHT;
+    int lookUp = GLFW_KEY_UP;
+    int lookDown = GLFW_KEY_DOWN;
+  };
+
   Window(int w, int h, std::string name);
   ~Window();
 
@@ -20,6 +36,11 @@ public:
   void resetWindowResizedFlag() { mFramebufferResized = false; }
   GLFWwindow *getGLFWwindow() const { return mWindow; }
 
+  // Buttons held right now, call it after glfwPollEvents
+  InputState pollInput() const;
+
+  KeyMappings mKeys{};
+
   void createWindowSurface(VkInstance instance, VkSurfaceKHR *surface);
 
 private:
@@ -0,0 +1,220 @@
+// Deferred structural changes through CommandBuffer, bulk spawning and prefabs
+
+#include "test.hpp"
+
+#include "../src/ECS/Base/command_buffer.hpp"
+
+// std
+#include <string>
+#include <thread>
+
+namespace {
+
+struct Health {
+  int value;
+};
+
+struct Armor {
+  int value;
+};
+
+struct Name {
+  std::string value;
+};
+
+TEST(flushAppliesTheLastCommandPerComponent) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    centralizer.registerComponent<Health>();
+    centralizer.registerComponent<Armor>();
+    const ecs::Entity entity = centralizer.createEntity();
+    centralizer.addComponent(entity, Armor{1});
+
+    ecs::CommandBuffer commands{centralizer};
+    commands.addComponent(entity, Health{1});
+    commands.addComponent(entity, Health{2});
+    commands.removeComponent<Armor>(entity);
+    commands.addComponent(entity, Armor{3});
+    commands.removeComponent<Armor>(entity);
+    // nothing moves before the flush
+    CHECK(!centralizer.hasComponent<Health>(entity));
+
+    commands.flush();
+    CHECK(commands.empty());
+    CHECK(centralizer.getComponent<Health>(entity).value == 2);
+    CHECK(!centralizer.hasComponent<Armor>(entity));
+  }
+}
+
+TEST(overwritingOwnedComponentsKeepsTheStructure) {
+  ecs::Centralizer centralizer;
+  centralizer.registerComponent<Health>();
+  const ecs::Entity entity = centralizer.createEntity();
+  centralizer.addComponent(entity, Health{1});
+  const std::uint64_t version = centralizer.getStructureVersion();
+
+  ecs::CommandBuffer commands{centralizer};
+  commands.addComponent(entity, Health{5});
+  commands.flush();
+  CHECK(centralizer.getComponent<Health>(entity).value == 5);
+  CHECK(centralizer.getStructureVersion() == version);
+}
+
+TEST(createdEntitiesOnlyExistOnceFlushed) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    centralizer.registerComponent<Health>();
+    ecs::CommandBuffer commands{centralizer};
+    const ecs::Entity created = commands.createEntity();
+    commands.addComponent(created, Health{7});
+
+    // direct creations in between don't make it alive nor reuse it
+    const ecs::Entity direct = centralizer.createEntity();
+    CHECK(direct != created);
+    CHECK(!centralizer.isAlive(created));
+    CHECK(centralizer.view<Health>().sizeHint() == 0);
+
+    commands.flush();
+    CHECK(centralizer.isAlive(created));
+    CHECK(centralizer.getComponent<Health>(created).value == 7);
+  }
+}
+
+TEST(otherBuffersSkipEntitiesNotFlushedYet) {
+  ecs::Centralizer centralizer;
+  centralizer.registerComponent<Health>();
+  ecs::CommandBuffer creator{centralizer};
+  ecs::CommandBuffer other{centralizer};
+  const ecs::Entity created = creator.createEntity();
+  other.addComponent(created, Health{1});
+  other.flush();
+  creator.flush();
+  CHECK(centralizer.isAlive(created));
+  CHECK(!centralizer.hasComponent<Health>(created));
+}
+
+TEST(createThenDestroyInOneBuffer) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    centralizer.registerComponent<Health>();
+    ecs::CommandBuffer commands{centralizer};
+    const ecs::Entity entity = commands.createEntity();
+    commands.addComponent(entity, Health{1});
+    commands.destroyEntity(entity);
+    commands.flush();
+    CHECK(!centralizer.isAlive(entity));
+    CHECK(centralizer.view<Health>().sizeHint() == 0);
+  }
+}
+
+TEST(unflushedBuffersReleaseTheirEntities) {
+  ecs::Centralizer centralizer;
+  centralizer.registerComponent<Health>();
+  ecs::Entity dropped{};
+  {
+    ecs::CommandBuffer commands{centralizer};
+    dropped = commands.createEntity();
+    commands.addComponent(dropped, Health{1});
+  }
+  CHECK(!centralizer.isAlive(dropped));
+  // the slot comes back with a new generation
+  const ecs::Entity next = centralizer.createEntity();
+  CHECK(ecs::entityIndex(next) == ecs::entityIndex(dropped));
+  CHECK(next != dropped);
+}
+
+TEST(buffersRecordFromParallelJobs) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    centralizer.registerComponent<Health>();
+    for (int i{0}; i < 32; ++i) {
+      centralizer.destroyEntity(centralizer.createEntity());
+    }
+
+    std::vector<std::unique_ptr<ecs::CommandBuffer>> buffers;
+    for (int t{0}; t < 4; ++t) {
+      buffers.push_back(std::make_unique<ecs::CommandBuffer>(centralizer));
+    }
+    std::vector<std::thread> threads;
+    for (int t{0}; t < 4; ++t) {
+      threads.emplace_back([&buffers, t] {
+        for (int i{0}; i < 50; ++i) {
+          ecs::CommandBuffer &commands = *buffers[t];
+          commands.addComponent(commands.createEntity(), Health{t});
+        }
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    for (auto &buffer : buffers) {
+      buffer->flush();
+    }
+
+    int sum{0};
+    size_t count{0};
+    centralizer.view<Health>().each([&](ecs::Entity, Health &health) {
+      sum += health.value;
+      ++count;
+    });
+    CHECK(count == 200);
+    CHECK(sum == 50 * (0 + 1 + 2 + 3));
+  }
+}
+
+TEST(spawnBatchFillsEveryComponent) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    centralizer.registerComponent<Health>();
+    centralizer.registerComponent<Name>();
+    // more than one run of the sparse set path
+    const std::vector<ecs::Entity> entities =
+        centralizer.spawnBatch<Health, Name>(2500, [](size_t i) {
+          return std::tuple{Health{static_cast<int>(i)}, Name{std::to_string(i)}};
+        });
+    CHECK(entities.size() == 2500);
+
+    bool filled = true;
+    for (size_t i{0}; i < entities.size(); ++i) {
+      const ecs::Entity e = entities[i];
+      filled = filled && centralizer.getComponent<Health>(e).value == static_cast<int>(i) &&
+               centralizer.getComponent<Name>(e).value == std::to_string(i) &&
+               centralizer.getComponentTicks<Health>(e).added == centralizer.getTick();
+    }
+    CHECK(filled);
+  }
+}
+
+TEST(spawnBatchJoinsGroups) {
+  ecs::Centralizer centralizer;
+  centralizer.registerComponent<Health>();
+  centralizer.registerComponent<Armor>();
+  centralizer.group<Health, Armor>();
+  centralizer.addComponent(centralizer.createEntity(), Health{0});
+  centralizer.spawnBatch<Health, Armor>(1500, [](size_t i) {
+    return std::tuple{Health{1}, Armor{static_cast<int>(i)}};
+  });
+
+  size_t count{0};
+  centralizer.group<Health, Armor>().each([&](ecs::Entity, Health &health, Armor &) {
+    count += health.value;
+  });
+  CHECK(count == 1500);
+}
+
+TEST(prefabsAreCopied) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    centralizer.registerComponent<Health>();
+    centralizer.registerComponent<Armor>();
+    const auto prefab = ecs::makePrefab(Health{10}, Armor{2});
+    const std::vector<ecs::Entity> entities = centralizer.createEntities(100, prefab);
+    centralizer.getComponent<Health>(entities[0]).value = 0;
+    CHECK(centralizer.getComponent<Health>(entities[1]).value == 10);
+    CHECK(centralizer.getComponent<Armor>(entities[99]).value == 2);
+  }
+}
+
+} // namespace
+
+int main() { return test::runAll(); }
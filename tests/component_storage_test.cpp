@@ -0,0 +1,134 @@
+// Sparse set, paged vector and component array: the storage under the sparse set backend
+
+#include "test.hpp"
+
+// std
+#include <memory>
+#include <string>
+
+namespace {
+
+struct Position {
+  float x, y, z;
+};
+
+struct Name {
+  std::string value;
+};
+
+TEST(sparseSetInsertErase) {
+  ecs::SparseSet set;
+  const ecs::Entity a = ecs::makeEntity(3, 0);
+  const ecs::Entity b = ecs::makeEntity(5000, 0);
+  const ecs::Entity c = ecs::makeEntity(7, 2);
+  set.insert(a);
+  set.insert(b);
+  set.insert(c);
+  CHECK(set.size() == 3);
+  CHECK(set.contains(b) && set.index(b) == 1);
+
+  // the last entity fills the hole
+  set.erase(a);
+  CHECK(!set.contains(a));
+  CHECK(set.index(c) == 0);
+  CHECK(set.size() == 2);
+}
+
+TEST(sparseSetRejectsStaleHandles) {
+  ecs::SparseSet set;
+  set.insert(ecs::makeEntity(4, 1));
+  CHECK(set.contains(ecs::makeEntity(4, 1)));
+  CHECK(!set.contains(ecs::makeEntity(4, 2)));
+  CHECK(!set.contains(ecs::makeEntity(9, 1)));
+}
+
+TEST(sparseSetSortAndSwap) {
+  ecs::SparseSet set;
+  for (ecs::Entity index : {9u, 2u, 5u}) {
+    set.insert(ecs::makeEntity(index, 0));
+  }
+  set.sort();
+  CHECK(set.data()[0] == ecs::makeEntity(2, 0) && set.data()[2] == ecs::makeEntity(9, 0));
+  set.swap(0, 2);
+  CHECK(set.index(ecs::makeEntity(9, 0)) == 0 && set.index(ecs::makeEntity(2, 0)) == 2);
+}
+
+TEST(pagedVectorKeepsAddresses) {
+  ecs::PagedVector<Position> values;
+  values.push_back(Position{1.f, 2.f, 3.f});
+  const Position *first = &values[0];
+  for (int i{0}; i < 10000; ++i) {
+    values.push_back(Position{});
+  }
+  CHECK(&values[0] == first);
+  CHECK(values[0].y == 2.f);
+  CHECK(values.size() == 10001);
+}
+
+TEST(pagedVectorAppendsAcrossPages) {
+  constexpr size_t count = ecs::PagedVector<int>::PAGE_SIZE * 2 + 17;
+  std::vector<int> source(count);
+  for (size_t i{0}; i < count; ++i) {
+    source[i] = static_cast<int>(i);
+  }
+  ecs::PagedVector<int> values;
+  values.push_back(-1);
+  values.append(reinterpret_cast<const std::byte *>(source.data()), count);
+  values.append(3, 42);
+  CHECK(values.size() == count + 4);
+  CHECK(values[1] == 0 && values[count] == static_cast<int>(count - 1));
+  CHECK(values[count + 3] == 42);
+}
+
+TEST(pagedVectorAppendMovedOwnsTheValues) {
+  std::vector<std::unique_ptr<int>> source;
+  for (int i{0}; i < 5000; ++i) {
+    source.push_back(std::make_unique<int>(i));
+  }
+  ecs::PagedVector<std::unique_ptr<int>> values;
+  values.appendMoved(source.data(), source.size());
+  CHECK(values.size() == 5000);
+  CHECK(*values[4999] == 4999);
+  CHECK(source[0] == nullptr);
+}
+
+TEST(componentArrayRemoveKeepsTicks) {
+  ecs::ComponentArray<Name> names;
+  const ecs::Entity a = ecs::makeEntity(0, 0);
+  const ecs::Entity b = ecs::makeEntity(1, 0);
+  names.insertData(a, Name{"a"}, 1);
+  names.insertData(b, Name{"b"}, 2);
+  names.removeData(a);
+  CHECK(names.size() == 1);
+  CHECK(names.getData(b).value == "b");
+  CHECK(names.getTicks(b).added == 2);
+}
+
+TEST(componentTypeIdsAreStable) {
+  const size_t position = ecs::componentTypeId<Position>();
+  CHECK(position == ecs::componentTypeId<Position>());
+  CHECK(position != ecs::componentTypeId<Name>());
+  CHECK(ecs::componentSignature<Position, Name>().count() == 2);
+
+  ecs::Centralizer centralizer;
+  centralizer.registerComponent<Position>();
+  CHECK(centralizer.getComponentType<Position>() == position);
+}
+
+TEST(worldGrowsPastTheOldEntityCap) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    centralizer.registerComponent<Position>();
+    ecs::Entity last{};
+    for (int i{0}; i < 20000; ++i) {
+      last = centralizer.createEntity();
+      centralizer.addComponent(last, Position{static_cast<float>(i), 0.f, 0.f});
+    }
+    CHECK(centralizer.getComponent<Position>(last).x == 19999.f);
+    CHECK(centralizer.view<Position>().sizeHint() == 20000);
+  }
+}
+
+} // namespace
+
+int main() { return test::runAll(); }
@@ -0,0 +1,142 @@
+// Generational handles, slot recycling, reservations and independent worlds
+
+#include "test.hpp"
+
+// std
+#include <set>
+#include <thread>
+
+namespace {
+
+struct Health {
+  int value;
+};
+
+TEST(destroyedHandlesStayDead) {
+  ecs::EntityManager entities;
+  const ecs::Entity a = entities.createEntity();
+  entities.destroyEntity(a);
+  const ecs::Entity b = entities.createEntity();
+  // same slot, new generation
+  CHECK(ecs::entityIndex(a) == ecs::entityIndex(b));
+  CHECK(a != b);
+  CHECK(!entities.isAlive(a));
+  CHECK(entities.isAlive(b));
+}
+
+TEST(freedSlotsAreRecycledOldestFirst) {
+  ecs::EntityManager entities;
+  std::vector<ecs::Entity> created;
+  for (int i{0}; i < 4; ++i) {
+    created.push_back(entities.createEntity());
+  }
+  entities.destroyEntity(created[2]);
+  entities.destroyEntity(created[0]);
+  CHECK(ecs::entityIndex(entities.createEntity()) == ecs::entityIndex(created[2]));
+  CHECK(ecs::entityIndex(entities.createEntity()) == ecs::entityIndex(created[0]));
+  CHECK(ecs::entityIndex(entities.createEntity()) == 4);
+  CHECK(entities.getLivingEntityCount() == 5);
+}
+
+TEST(reservationsStayDeadUntilCreated) {
+  ecs::EntityManager entities;
+  entities.destroyEntity(entities.createEntity());
+  const ecs::Entity recycled = entities.reserveEntity();
+  const ecs::Entity fresh = entities.reserveEntity();
+
+  // a direct creation claims the reservations without handing them out again
+  const ecs::Entity direct = entities.createEntity();
+  CHECK(direct != recycled && direct != fresh);
+  CHECK(!entities.isAlive(recycled) && !entities.isAlive(fresh));
+  CHECK(entities.getLivingEntityCount() == 1);
+
+  entities.createReserved(recycled);
+  CHECK(entities.isAlive(recycled));
+  CHECK(entities.getLivingEntityCount() == 2);
+  CHECK(entities.getLivingEntities().size() == 2);
+}
+
+TEST(releasedReservationsGoBackToTheFreeList) {
+  ecs::EntityManager entities;
+  const ecs::Entity reserved = entities.reserveEntity();
+  entities.createEntity();
+  entities.releaseReserved(reserved);
+  CHECK(!entities.isAlive(reserved));
+
+  const ecs::Entity next = entities.createEntity();
+  CHECK(ecs::entityIndex(next) == ecs::entityIndex(reserved));
+  CHECK(next != reserved);
+  CHECK(entities.getLivingEntityCount() == 2);
+}
+
+TEST(reservationsFromSeveralThreadsAreUnique) {
+  ecs::EntityManager entities;
+  for (int i{0}; i < 64; ++i) {
+    entities.destroyEntity(entities.createEntity());
+  }
+  std::vector<std::vector<ecs::Entity>> reserved(4);
+  std::vector<std::thread> threads;
+  for (size_t t{0}; t < reserved.size(); ++t) {
+    threads.emplace_back([&entities, &reserved, t] {
+      for (int i{0}; i < 100; ++i) {
+        reserved[t].push_back(entities.reserveEntity());
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  std::set<ecs::Entity> unique;
+  for (const std::vector<ecs::Entity> &handles : reserved) {
+    unique.insert(handles.begin(), handles.end());
+  }
+  CHECK(unique.size() == 400);
+  for (ecs::Entity entity : unique) {
+    entities.createReserved(entity);
+  }
+  CHECK(entities.getLivingEntityCount() == 400);
+}
+
+TEST(worldsDontShareEntities) {
+  ecs::Centralizer first;
+  ecs::Centralizer second;
+  first.registerComponent<Health>();
+  second.registerComponent<Health>();
+
+  const ecs::Entity a = first.createEntity();
+  first.addComponent(a, Health{1});
+  first.createEntity();
+  const ecs::Entity b = second.createEntity();
+  second.addComponent(b, Health{2});
+
+  CHECK(a == b);
+  CHECK(first.getComponent<Health>(a).value == 1);
+  CHECK(second.getComponent<Health>(b).value == 2);
+  CHECK(first.view<Health>().sizeHint() == 1 && second.view<Health>().sizeHint() == 1);
+}
+
+TEST(worldsRunOnSeparateThreads) {
+  std::vector<int> sums(3);
+  std::vector<std::thread> threads;
+  for (size_t w{0}; w < sums.size(); ++w) {
+    threads.emplace_back([&sums, w] {
+      ecs::Centralizer centralizer{test::BACKENDS[w % 2]};
+      centralizer.registerComponent<Health>();
+      centralizer.createEntities(1000, ecs::makePrefab(Health{static_cast<int>(w)}));
+      centralizer.getJobSystem().parallelFor(centralizer.view<Health>(), 64,
+                                             [](ecs::Entity, Health &health) { ++health.value; });
+      centralizer.view<Health>().each([&](ecs::Entity, Health &health) {
+        sums[w] += health.value;
+      });
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  CHECK(sums[0] == 1000 && sums[1] == 2000 && sums[2] == 3000);
+}
+
+} // namespace
+
+int main() { return test::runAll(); }
@@ -0,0 +1,40 @@
+// Fixed simulation steps out of variable frame times
+
+#include "test.hpp"
+
+#include "../src/ECS/Base/fixed_timestep.hpp"
+
+namespace {
+
+TEST(stepsFollowTheAccumulatedTime) {
+  ecs::FixedTimestep timestep{60.f, 5};
+  CHECK(timestep.advance(1.f / 120.f) == 0);
+  CHECK(timestep.alpha() > 0.45f && timestep.alpha() < 0.55f);
+  CHECK(timestep.advance(1.f / 120.f) == 1);
+  CHECK(timestep.advance(2.5f / 60.f) == 2);
+  CHECK(timestep.alpha() > 0.45f && timestep.alpha() < 0.55f);
+}
+
+TEST(frameOfOneStepRunsOneStep) {
+  // every tick rate, the float step handed out must map back to exactly one step
+  for (int rate{1}; rate <= 1000; ++rate) {
+    ecs::FixedTimestep timestep{static_cast<float>(rate), 5};
+    bool exact = true;
+    for (int frame{0}; frame < 10; ++frame) {
+      exact = exact && timestep.advance(timestep.step()) == 1;
+    }
+    CHECK(exact);
+  }
+}
+
+TEST(slowFramesAreCapped) {
+  ecs::FixedTimestep timestep{60.f, 4};
+  CHECK(timestep.advance(1.f) == 4);
+  // the time beyond the cap is dropped, not carried
+  CHECK(timestep.advance(0.f) == 0);
+  CHECK(timestep.alpha() < 1.f);
+}
+
+} // namespace
+
+int main() { return test::runAll(); }
@@ -0,0 +1,132 @@
+// Parent / Children hierarchies propagated by the HierarchySystem, needs glm
+
+#include "test.hpp"
+
+#include "../src/ECS/Systems/hierarchy_system.hpp"
+#include "../src/ECS/Systems/transform_system.hpp"
+#include "../src/scene.hpp"
+
+// std
+#include <cmath>
+#include <memory>
+
+namespace {
+
+struct World {
+  explicit World(ecs::StorageBackend backend) : centralizer{backend} {
+    vu::registerSceneComponents(centralizer);
+    transforms = centralizer.registerSystem<ecs::TransformSystem>(centralizer);
+    hierarchy = centralizer.registerSystem<ecs::HierarchySystem>(centralizer);
+  }
+
+  ecs::Entity node(const glm::vec3 &position) {
+    const ecs::Entity e = centralizer.createEntity();
+    centralizer.addComponent(e, ecs::Transform{position});
+    centralizer.addComponent(e, ecs::WorldMatrix{});
+    centralizer.addComponent(e, ecs::LocalTransform{ecs::Transform{position}});
+    return e;
+  }
+
+  // one frame of the app
+  void update() {
+    centralizer.dispatchEvents();
+    transforms->update();
+    hierarchy->update();
+  }
+
+  glm::vec3 worldPosition(ecs::Entity e) {
+    return glm::vec3{centralizer.getComponent<ecs::WorldMatrix>(e).model[3]};
+  }
+
+  ecs::Centralizer centralizer;
+  std::shared_ptr<ecs::TransformSystem> transforms;
+  std::shared_ptr<ecs::HierarchySystem> hierarchy;
+};
+
+bool near(const glm::vec3 &a, const glm::vec3 &b) {
+  return std::abs(a.x - b.x) + std::abs(a.y - b.y) + std::abs(a.z - b.z) < 1e-4f;
+}
+
+TEST(childrenFollowTheirParent) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    World world{backend};
+    const ecs::Entity root = world.node({1.f, 0.f, 0.f});
+    const ecs::Entity child = world.node({0.f, 2.f, 0.f});
+    const ecs::Entity grandchild = world.node({0.f, 0.f, 3.f});
+    ecs::HierarchySystem::attach(world.centralizer, child, root);
+    ecs::HierarchySystem::attach(world.centralizer, grandchild, child);
+    world.update();
+    CHECK(near(world.worldPosition(grandchild), {1.f, 2.f, 3.f}));
+    CHECK(near(world.centralizer.getComponent<ecs::Transform>(grandchild).position(),
+               {1.f, 2.f, 3.f}));
+
+    world.centralizer.getComponent<ecs::Transform>(root).translate({10.f, 0.f, 0.f});
+    world.update();
+    CHECK(near(world.worldPosition(child), {11.f, 2.f, 0.f}));
+    CHECK(near(world.worldPosition(grandchild), {11.f, 2.f, 3.f}));
+  }
+}
+
+TEST(destroyedChildLeavesItsParent) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    World world{backend};
+    const ecs::Entity root = world.node({});
+    const ecs::Entity first = world.node({});
+    const ecs::Entity second = world.node({});
+    ecs::HierarchySystem::attach(world.centralizer, first, root);
+    ecs::HierarchySystem::attach(world.centralizer, second, root);
+    world.update();
+
+    world.centralizer.destroyEntity(first);
+    // propagating before the events are dispatched skips the dead child
+    world.hierarchy->update();
+    world.update();
+    CHECK(world.centralizer.getComponent<ecs::Children>(root).entities ==
+          std::vector<ecs::Entity>{second});
+
+    world.centralizer.destroyEntity(second);
+    world.update();
+    CHECK(!world.centralizer.hasComponent<ecs::Children>(root));
+  }
+}
+
+TEST(destroyedParentLeavesRoots) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    World world{backend};
+    const ecs::Entity root = world.node({});
+    const ecs::Entity middle = world.node({1.f, 0.f, 0.f});
+    const ecs::Entity leaf = world.node({0.f, 1.f, 0.f});
+    ecs::HierarchySystem::attach(world.centralizer, middle, root);
+    ecs::HierarchySystem::attach(world.centralizer, leaf, middle);
+    world.update();
+
+    world.centralizer.destroyEntity(middle);
+    world.hierarchy->update();
+    world.update();
+    CHECK(!world.centralizer.hasComponent<ecs::Parent>(leaf));
+    CHECK(!world.centralizer.hasComponent<ecs::Children>(root));
+    // the orphan keeps its last world matrix
+    CHECK(near(world.worldPosition(leaf), {1.f, 1.f, 0.f}));
+
+    // and can join another parent
+    ecs::HierarchySystem::attach(world.centralizer, leaf, root);
+    world.update();
+    CHECK(world.centralizer.getComponent<ecs::Parent>(leaf).entity == root);
+  }
+}
+
+TEST(detachKeepsTheWorldMatrix) {
+  World world{ecs::StorageBackend::SparseSet};
+  const ecs::Entity root = world.node({5.f, 0.f, 0.f});
+  const ecs::Entity child = world.node({0.f, 5.f, 0.f});
+  ecs::HierarchySystem::attach(world.centralizer, child, root);
+  world.update();
+  ecs::HierarchySystem::detach(world.centralizer, child);
+  world.update();
+  CHECK(!world.centralizer.hasComponent<ecs::Parent>(child));
+  CHECK(near(world.worldPosition(child), {5.f, 5.f, 0.f}));
+}
+
+} // namespace
+
+int main() { return test::runAll(); }
@@ -0,0 +1,128 @@
+// Work stealing JobSystem and the dependency aware Scheduler
+
+#include "test.hpp"
+
+#include "../src/ECS/Base/scheduler.hpp"
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+struct Position {
+  float x;
+};
+
+struct Velocity {
+  float x;
+};
+
+TEST(parallelForCoversEveryIndexOnce) {
+  ecs::JobSystem jobs{3};
+  std::vector<std::atomic<int>> visits(10007);
+  jobs.parallelFor(visits.size(), 64, [&](size_t begin, size_t end) {
+    for (size_t i{begin}; i < end; ++i) {
+      visits[i].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  CHECK(std::all_of(visits.begin(), visits.end(),
+                    [](const std::atomic<int> &visit) { return visit == 1; }));
+}
+
+TEST(jobsCanWaitForNestedJobs) {
+  ecs::JobSystem jobs{2};
+  std::atomic<int> leaves{0};
+  jobs.parallelFor(8, 1, [&](size_t, size_t) {
+    jobs.parallelFor(8, 1, [&](size_t, size_t) { leaves.fetch_add(1); });
+  });
+  CHECK(leaves == 64);
+}
+
+TEST(parallelForOverViews) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    centralizer.registerComponent<Position>();
+    centralizer.createEntities(5000, ecs::makePrefab(Position{1.f}));
+    centralizer.getJobSystem().parallelFor(centralizer.view<Position>(), 128,
+                                           [](ecs::Entity, Position &position) {
+                                             position.x *= 2;
+                                           });
+    float sum{0.f};
+    centralizer.view<Position>().each([&](ecs::Entity, Position &position) { sum += position.x; });
+    CHECK(sum == 10000.f);
+  }
+}
+
+TEST(idleWorkersSleep) {
+  ecs::JobSystem jobs{3};
+  jobs.parallelFor(1000, 1, [](size_t, size_t) {});
+  const std::clock_t start = std::clock();
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  // process cpu time, spinning workers would burn about 600ms
+  const double ms = 1000.0 * static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+  CHECK(ms < 100.0);
+}
+
+TEST(worldsShareAnInjectedPool) {
+  ecs::JobSystem jobs{2};
+  ecs::Centralizer first{ecs::StorageBackend::SparseSet, jobs};
+  ecs::Centralizer second{ecs::StorageBackend::Archetype, jobs};
+  CHECK(&first.getJobSystem() == &jobs);
+  CHECK(&second.getJobSystem() == &jobs);
+
+  ecs::Centralizer own;
+  CHECK(&own.getJobSystem() != &jobs);
+}
+
+TEST(schedulerOrdersConflictingTasks) {
+  ecs::JobSystem jobs{3};
+  ecs::Scheduler scheduler{jobs};
+  const ecs::Signature position = ecs::componentSignature<Position>();
+  const ecs::Signature velocity = ecs::componentSignature<Velocity>();
+
+  std::mutex mutex;
+  std::vector<int> order;
+  auto log = [&](int task) {
+    std::lock_guard<std::mutex> lock{mutex};
+    order.push_back(task);
+  };
+  // 0 writes Position, 1 reads it, 2 writes it again: 0 then 1 then 2
+  scheduler.add(ecs::Signature{}, position, [&] { log(0); });
+  scheduler.add(position, velocity, [&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    log(1);
+  });
+  scheduler.add(ecs::Signature{}, position, [&] { log(2); });
+  scheduler.run();
+
+  CHECK(order == std::vector<int>{0, 1, 2});
+}
+
+TEST(schedulerRunsIndependentTasksTogether) {
+  ecs::JobSystem jobs{3};
+  ecs::Scheduler scheduler{jobs};
+  // the two tasks only meet if they run at the same time
+  std::atomic<int> arrived{0};
+  std::atomic<bool> met{false};
+  auto task = [&] {
+    arrived.fetch_add(1);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (arrived < 2 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+    met = met || arrived == 2;
+  };
+  scheduler.add(ecs::componentSignature<Velocity>(), ecs::componentSignature<Position>(), task);
+  scheduler.add(ecs::componentSignature<Velocity>(), ecs::Signature{}, task);
+  scheduler.run();
+  CHECK(met);
+}
+
+} // namespace
+
+int main() { return test::runAll(); }
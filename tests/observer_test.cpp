@@ -0,0 +1,96 @@
+// Batched component observers
+
+#include "test.hpp"
+
+#include "../src/ECS/Base/command_buffer.hpp"
+
+namespace {
+
+struct Health {
+  int value;
+};
+
+struct Events {
+  std::vector<ecs::Entity> added;
+  std::vector<ecs::Entity> removed;
+  std::vector<ecs::Entity> updated;
+  int batches{0};
+};
+
+void observe(ecs::Centralizer &centralizer, Events &events) {
+  centralizer.onAdd<Health>([&events](const std::vector<ecs::Entity> &entities) {
+    events.added.insert(events.added.end(), entities.begin(), entities.end());
+    ++events.batches;
+  });
+  centralizer.onRemove<Health>([&events](const std::vector<ecs::Entity> &entities) {
+    events.removed.insert(events.removed.end(), entities.begin(), entities.end());
+    ++events.batches;
+  });
+  centralizer.onUpdate<Health>([&events](const std::vector<ecs::Entity> &entities) {
+    events.updated.insert(events.updated.end(), entities.begin(), entities.end());
+    ++events.batches;
+  });
+}
+
+TEST(observersGetOneBatchPerDispatch) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    centralizer.registerComponent<Health>();
+    Events events;
+    observe(centralizer, events);
+
+    const std::vector<ecs::Entity> entities =
+        centralizer.createEntities(100, ecs::makePrefab(Health{1}));
+    centralizer.patch<Health>(entities[0], [](Health &health) { health.value = 2; });
+    centralizer.markChanged<Health>(entities[0]);
+    // nothing is called before the dispatch
+    CHECK(events.batches == 0);
+
+    centralizer.dispatchEvents();
+    CHECK(events.added.size() == 100);
+    CHECK(events.updated == std::vector<ecs::Entity>{entities[0]});
+    CHECK(events.batches == 2);
+
+    centralizer.dispatchEvents();
+    CHECK(events.batches == 2);
+  }
+}
+
+TEST(removalsListDestroyedEntities) {
+  ecs::Centralizer centralizer;
+  centralizer.registerComponent<Health>();
+  Events events;
+  observe(centralizer, events);
+
+  const ecs::Entity kept = centralizer.createEntity();
+  const ecs::Entity destroyed = centralizer.createEntity();
+  centralizer.addComponent(kept, Health{1});
+  centralizer.addComponent(destroyed, Health{1});
+  centralizer.dispatchEvents();
+
+  centralizer.markChanged<Health>(destroyed);
+  centralizer.destroyEntity(destroyed);
+  centralizer.removeComponent<Health>(kept);
+  centralizer.dispatchEvents();
+  CHECK(events.removed.size() == 2);
+  // updates only list entities still owning the component
+  CHECK(events.updated.empty());
+}
+
+TEST(commandBufferFlushesAreObserved) {
+  ecs::Centralizer centralizer;
+  centralizer.registerComponent<Health>();
+  Events events;
+  observe(centralizer, events);
+
+  ecs::CommandBuffer commands{centralizer};
+  const ecs::Entity entity = commands.createEntity();
+  commands.addComponent(entity, Health{1});
+  commands.flush();
+  centralizer.dispatchEvents();
+  CHECK(events.added == std::vector<ecs::Entity>{entity});
+}
+
+} // namespace
+
+int main() { return test::runAll(); }
@@ -0,0 +1,55 @@
+// Profiler zones and their Chrome trace, built with MACHINA_PROFILING
+
+#include "test.hpp"
+
+#include "../src/profiler/profiler.hpp"
+
+// std
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+std::string readFile(const std::string &path) {
+  std::ifstream in{path};
+  std::stringstream content;
+  content << in.rdbuf();
+  return content.str();
+}
+
+TEST(traceHoldsZonesOfEveryThread) {
+  {
+    ecs::JobSystem jobs{2};
+    PROFILE_THREAD("Main");
+    PROFILE_ZONE("traceHoldsZonesOfEveryThread");
+    jobs.parallelFor(64, 1, [](size_t, size_t) {});
+  }
+
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "machina_profiler_test.json").string();
+  CHECK(prof::Profiler::get().writeChromeTrace(path));
+  const std::string trace = readFile(path);
+  CHECK(trace.find("\"traceEvents\"") != std::string::npos);
+  CHECK(trace.find("\"name\": \"traceHoldsZonesOfEveryThread\", \"ph\": \"X\"") !=
+        std::string::npos);
+  CHECK(trace.find("\"args\": {\"name\": \"Main\"}") != std::string::npos);
+  CHECK(trace.find("\"args\": {\"name\": \"Worker 1\"}") != std::string::npos);
+  std::remove(path.c_str());
+}
+
+TEST(ringKeepsTheNewestZones) {
+  prof::ThreadBuffer buffer{0};
+  const size_t count = prof::ThreadBuffer::CAPACITY + 5;
+  for (size_t i{0}; i < count; ++i) {
+    buffer.push(prof::ZoneEvent{"zone", i, i + 1});
+  }
+  const std::vector<prof::ZoneEvent> events = buffer.events();
+  CHECK(events.size() == prof::ThreadBuffer::CAPACITY);
+  CHECK(events.front().begin == 5 && events.back().begin == count - 1);
+}
+
+} // namespace
+
+int main() { return test::runAll(); }
@@ -0,0 +1,58 @@
+// Recording and replaying the input of a session
+
+#include "test.hpp"
+
+#include "../src/input/session.hpp"
+
+// std
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+
+namespace {
+
+TEST(replayGivesBackTheRecordedFrames) {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "machina_session_test.bin").string();
+  const vu::SessionHeader header{1234, 120.f, 3, 50};
+  {
+    vu::SessionRecorder recorder{path, header};
+    for (int i{0}; i < 10; ++i) {
+      vu::SessionFrame frame{0.01f * static_cast<float>(i), {}};
+      if (i % 2 == 0) {
+        frame.input.press(vu::InputButton::MoveForward);
+      }
+      recorder.record(frame);
+    }
+  }
+
+  vu::SessionReplayer replayer{path};
+  CHECK(replayer.header().seed == 1234 && replayer.header().tickRate == 120.f);
+  CHECK(replayer.header().maxStepsPerFrame == 3 && replayer.header().bodies == 50);
+  CHECK(replayer.frameCount() == 10);
+
+  vu::SessionFrame frame{};
+  bool same = true;
+  for (int i{0}; i < 10; ++i) {
+    same = same && replayer.next(frame) && frame.frameTime == 0.01f * static_cast<float>(i) &&
+           frame.input.pressed(vu::InputButton::MoveForward) == (i % 2 == 0) &&
+           !frame.input.pressed(vu::InputButton::LookUp);
+  }
+  CHECK(same);
+  CHECK(!replayer.next(frame));
+  std::remove(path.c_str());
+}
+
+TEST(replayingAMissingFileThrows) {
+  bool thrown = false;
+  try {
+    vu::SessionReplayer replayer{"machina_session_missing.bin"};
+  } catch (const std::runtime_error &) {
+    thrown = true;
+  }
+  CHECK(thrown);
+}
+
+} // namespace
+
+int main() { return test::runAll(); }
@@ -0,0 +1,80 @@
+// Binary world snapshots
+
+#include "test.hpp"
+
+#include "../src/ECS/Base/snapshot.hpp"
+
+// std
+#include <cstdio>
+#include <filesystem>
+
+namespace {
+
+struct Health {
+  int value;
+};
+
+struct Armor {
+  int value;
+};
+
+TEST(snapshotRoundTrip) {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "machina_snapshot_test.bin").string();
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer source{backend};
+    source.registerComponent<Health>();
+    source.registerComponent<Armor>();
+    std::vector<ecs::Entity> entities;
+    for (int i{0}; i < 300; ++i) {
+      const ecs::Entity entity = source.createEntity();
+      source.addComponent(entity, Health{i});
+      if (i % 3 == 0) {
+        source.addComponent(entity, Armor{-i});
+      }
+      entities.push_back(entity);
+    }
+    source.destroyEntity(entities[10]);
+    ecs::Snapshot saved{source};
+    saved.registerComponent<Health>("health");
+    saved.registerComponent<Armor>("armor");
+    CHECK(saved.save(path));
+
+    ecs::Centralizer target{backend};
+    target.registerComponent<Health>();
+    target.registerComponent<Armor>();
+    ecs::Snapshot loaded{target};
+    loaded.registerComponent<Health>("health");
+    loaded.registerComponent<Armor>("armor");
+    CHECK(loaded.load(path));
+
+    CHECK(!target.isAlive(entities[10]));
+    CHECK(target.getComponent<Health>(entities[42]).value == 42);
+    CHECK(target.getComponent<Armor>(entities[42]).value == -42);
+    CHECK(!target.hasComponent<Armor>(entities[43]));
+    CHECK(target.view<Health, Armor>().sizeHint() <= 100);
+    // the next entity reuses the destroyed slot like it would have in the source
+    CHECK(target.createEntity() == source.createEntity());
+  }
+  std::remove(path.c_str());
+}
+
+TEST(snapshotRejectsOtherFiles) {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "machina_snapshot_garbage.bin").string();
+  {
+    std::ofstream out{path, std::ios::binary};
+    out << "not a snapshot";
+  }
+  ecs::Centralizer centralizer;
+  centralizer.registerComponent<Health>();
+  ecs::Snapshot snapshot{centralizer};
+  snapshot.registerComponent<Health>("health");
+  CHECK(!snapshot.load(path));
+  CHECK(!snapshot.load(path + ".missing"));
+  std::remove(path.c_str());
+}
+
+} // namespace
+
+int main() { return test::runAll(); }
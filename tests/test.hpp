@@ -0,0 +1,63 @@
+#pragma once
+
+// Minimal harness shared by the test executables, one executable per ctest test.
+//   TEST(name) { CHECK(expression); }
+//   int main() { return test::runAll(); }
+// A failed CHECK prints its location and the test goes on, runAll() returns non zero when
+// any check failed. Checks don't depend on NDEBUG, the ECS asserts still do.
+
+#include "../src/ECS/Base/centralizer.hpp"
+
+// std
+#include <cstdio>
+#include <vector>
+
+namespace test {
+
+struct Case {
+  const char *name;
+  void (*fn)();
+};
+
+inline std::vector<Case> &cases() {
+  static std::vector<Case> registered;
+  return registered;
+}
+
+inline int gFailures{0};
+
+inline bool add(const char *name, void (*fn)()) {
+  cases().push_back(Case{name, fn});
+  return true;
+}
+
+inline void check(bool ok, const char *expression, const char *file, int line) {
+  if (!ok) {
+    ++gFailures;
+    std::printf("  %s:%d: CHECK(%s) failed\n", file, line, expression);
+  }
+}
+
+inline int runAll() {
+  for (const Case &c : cases()) {
+    const int failures = gFailures;
+    c.fn();
+    std::printf("%s %s\n", gFailures == failures ? "ok  " : "FAIL", c.name);
+  }
+  return gFailures == 0 ? 0 : 1;
+}
+
+// Tests written once and run against both storages loop over these
+constexpr ecs::StorageBackend BACKENDS[] = {ecs::StorageBackend::SparseSet,
+                                             ecs::StorageBackend::Archetype};
+
+} // namespace test
+
+#define TEST(name)                                                                             \
+  static void name();                                                                          \
+  static const bool name##Registered = ::test::add(#name, name);                               \
+  static void name()
+
+// variadic so template argument lists don't split the expression
+#define CHECK(...)                                                                             \
+  ::test::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
@@ -0,0 +1,78 @@
+// Transform dirty flags and the interpolated WorldMatrix of the TransformSystem, needs glm
+
+#include "test.hpp"
+
+#include "../src/ECS/Systems/transform_system.hpp"
+#include "../src/scene.hpp"
+
+// std
+#include <cmath>
+
+namespace {
+
+bool near(const glm::vec3 &a, const glm::vec3 &b) {
+  return std::abs(a.x - b.x) + std::abs(a.y - b.y) + std::abs(a.z - b.z) < 1e-4f;
+}
+
+TEST(mutatorsFlagTheTransform) {
+  ecs::Transform transform{{1.f, 2.f, 3.f}};
+  CHECK(transform.dirty);
+  CHECK(transform.scale() == glm::vec3{1.f, 1.f, 1.f});
+  transform.dirty = false;
+  transform.translate({1.f, 0.f, 0.f});
+  CHECK(transform.dirty && transform.position() == glm::vec3{2.f, 2.f, 3.f});
+
+  transform.dirty = false;
+  transform.mirrorWorldPosition({0.f, 0.f, 0.f});
+  CHECK(!transform.dirty && transform.position() == glm::vec3{0.f});
+}
+
+TEST(dirtyTransformsRebuildTheirMatrix) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    vu::registerSceneComponents(centralizer);
+    auto system = centralizer.registerSystem<ecs::TransformSystem>(centralizer);
+    const ecs::Entity e = centralizer.createEntity();
+    centralizer.addComponent(e, ecs::Transform{{1.f, 0.f, 0.f}});
+    centralizer.addComponent(e, ecs::WorldMatrix{});
+    centralizer.dispatchEvents();
+    system->update();
+
+    ecs::WorldMatrix &world = centralizer.getComponent<ecs::WorldMatrix>(e);
+    CHECK(!centralizer.getComponent<ecs::Transform>(e).dirty);
+    CHECK(near(glm::vec3{world.model[3]}, {1.f, 0.f, 0.f}));
+    const std::uint32_t version = world.version;
+    system->update();
+    CHECK(world.version == version);
+
+    centralizer.getComponent<ecs::Transform>(e).setPosition({4.f, 0.f, 0.f});
+    system->update();
+    CHECK(world.version != version);
+    CHECK(near(glm::vec3{world.model[3]}, {4.f, 0.f, 0.f}));
+  }
+}
+
+TEST(fixedStepBodiesAreInterpolated) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    vu::registerSceneComponents(centralizer);
+    auto system = centralizer.registerSystem<ecs::TransformSystem>(centralizer);
+    const ecs::Entity e = centralizer.createEntity();
+    centralizer.addComponent(e, ecs::Transform{});
+    centralizer.addComponent(e, ecs::PreviousTransform{});
+    centralizer.addComponent(e, ecs::WorldMatrix{});
+    centralizer.dispatchEvents();
+
+    system->savePrevious();
+    centralizer.getComponent<ecs::Transform>(e).setPosition({2.f, 0.f, 0.f});
+    system->update(0.25f);
+    const ecs::WorldMatrix &world = centralizer.getComponent<ecs::WorldMatrix>(e);
+    CHECK(near(glm::vec3{world.model[3]}, {0.5f, 0.f, 0.f}));
+    system->update(1.f);
+    CHECK(near(glm::vec3{world.model[3]}, {2.f, 0.f, 0.f}));
+  }
+}
+
+} // namespace
+
+int main() { return test::runAll(); }
@@ -0,0 +1,146 @@
+// Views over both storage backends, change ticks, owned groups and system membership
+
+#include "test.hpp"
+
+// std
+#include <algorithm>
+
+namespace {
+
+struct Position {
+  float x;
+};
+
+struct Velocity {
+  float x;
+};
+
+struct Frozen {};
+
+class MovementSystem : public ecs::System {};
+
+TEST(viewVisitsEntitiesOwningEveryComponent) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    centralizer.registerComponent<Position>();
+    centralizer.registerComponent<Velocity>();
+    for (int i{0}; i < 100; ++i) {
+      const ecs::Entity entity = centralizer.createEntity();
+      centralizer.addComponent(entity, Position{0.f});
+      if (i % 4 == 0) {
+        centralizer.addComponent(entity, Velocity{static_cast<float>(i)});
+      }
+    }
+
+    size_t count{0};
+    centralizer.view<Position, Velocity>().each([&](ecs::Entity, Position &position,
+                                                    Velocity &velocity) {
+      position.x += velocity.x;
+      ++count;
+    });
+    CHECK(count == 25);
+
+    float sum{0.f};
+    centralizer.view<Position>().each([&](ecs::Entity, Position &position) { sum += position.x; });
+    CHECK(sum == 1200.f);
+  }
+}
+
+TEST(viewRangesSplitTheWalk) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    centralizer.registerComponent<Position>();
+    centralizer.createEntities(1000, ecs::makePrefab(Position{1.f}));
+    auto view = centralizer.view<Position>();
+    size_t count{0};
+    for (size_t begin{0}; begin < view.sizeHint(); begin += 300) {
+      view.eachInRange(begin, begin + 300, [&](ecs::Entity, Position &) { ++count; });
+    }
+    CHECK(count == 1000);
+  }
+}
+
+TEST(changedSinceKeepsFlaggedWrites) {
+  for (ecs::StorageBackend backend : test::BACKENDS) {
+    ecs::Centralizer centralizer{backend};
+    centralizer.registerComponent<Position>();
+    const std::vector<ecs::Entity> entities =
+        centralizer.createEntities(10, ecs::makePrefab(Position{0.f}));
+    const ecs::Tick spawned = centralizer.getTick();
+    centralizer.advanceTick();
+
+    centralizer.patch<Position>(entities[3], [](Position &position) { position.x = 3.f; });
+    // plain reference writes are not tracked
+    centralizer.getComponent<Position>(entities[4]).x = 4.f;
+    centralizer.markChanged<Position>(entities[5]);
+
+    std::vector<ecs::Entity> changed;
+    centralizer.view<Position>().changedSince(spawned).each(
+        [&](ecs::Entity entity, Position &) { changed.push_back(entity); });
+    std::sort(changed.begin(), changed.end());
+    CHECK(changed == std::vector<ecs::Entity>{entities[3], entities[5]});
+
+    size_t added{0};
+    centralizer.view<Position>().addedSince(spawned).each([&](ecs::Entity, Position &) {
+      ++added;
+    });
+    CHECK(added == 0);
+  }
+}
+
+TEST(groupPacksItsEntities) {
+  ecs::Centralizer centralizer;
+  centralizer.registerComponent<Position>();
+  centralizer.registerComponent<Velocity>();
+  std::vector<ecs::Entity> both;
+  for (int i{0}; i < 50; ++i) {
+    const ecs::Entity entity = centralizer.createEntity();
+    centralizer.addComponent(entity, Position{static_cast<float>(i)});
+    if (i % 2 == 1) {
+      centralizer.addComponent(entity, Velocity{static_cast<float>(i)});
+      both.push_back(entity);
+    }
+  }
+
+  const std::uint64_t version = centralizer.getStructureVersion();
+  auto group = centralizer.group<Position, Velocity>();
+  // building it swapped component slots
+  CHECK(centralizer.getStructureVersion() != version);
+  CHECK(group.sizeHint() == both.size());
+
+  bool matching = true;
+  group.each([&](ecs::Entity entity, Position &position, Velocity &velocity) {
+    matching = matching && position.x == velocity.x &&
+               &position == &centralizer.getComponent<Position>(entity);
+  });
+  CHECK(matching);
+
+  // maintained from then on
+  centralizer.removeComponent<Velocity>(both[0]);
+  centralizer.destroyEntity(both[1]);
+  CHECK(centralizer.group<Position, Velocity>().sizeHint() == both.size() - 2);
+}
+
+TEST(systemsTrackMatchingEntities) {
+  ecs::Centralizer centralizer;
+  centralizer.registerComponent<Position>();
+  centralizer.registerComponent<Frozen>();
+  auto system = centralizer.registerSystem<MovementSystem>();
+  centralizer.setSystemSignature<MovementSystem>(ecs::componentSignature<Position>());
+
+  const ecs::Entity a = centralizer.createEntity();
+  const ecs::Entity b = centralizer.createEntity();
+  centralizer.addComponent(a, Position{});
+  centralizer.addComponent(b, Position{});
+  centralizer.addComponent(b, Frozen{});
+  CHECK(system->mEntities.size() == 2);
+
+  centralizer.removeComponent<Position>(a);
+  CHECK(!system->mEntities.contains(a));
+  centralizer.destroyEntity(b);
+  CHECK(system->mEntities.empty());
+}
+
+} // namespace
+
+int main() { return test::runAll(); }